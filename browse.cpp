@@ -41,16 +41,26 @@
 #include <wrl/client.h>
 #include <winnetwk.h>
 #include <shellapi.h>      // ShellExecuteW, CommandLineToArgvW
+#include <winioctl.h>      // FSCTL_DUPLICATE_EXTENTS_TO_FILE
 
 #include <string>
 #include <vector>
 #include <algorithm>
 #include <atomic>
 #include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <deque>
 #include <cwchar>
 #include <climits>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <cmath>
 #include <fstream>
 #include <sstream>
 #include <cwctype>
@@ -58,6 +68,9 @@
 #include <cstdarg>
 #include <io.h>            // _unlink
 
+#include "namepattern.h"
+#include "xxh64.h"
+
 #ifndef CFSTR_PREFERREDDROPEFFECT
 #define CFSTR_PREFERREDDROPEFFECT L"Preferred DropEffect"
 #endif
@@ -102,6 +115,7 @@ static bool GetPersistentMappedRemotePath(wchar_t letter, std::wstring& outRemot
 static bool g_loadingFolder = false;
 HINSTANCE g_hInst = NULL;
 HWND g_hwndMain = NULL, g_hwndList = NULL, g_hwndVideo = NULL, g_hwndSeek = NULL;
+HWND g_hwndFilter = NULL;     // quick filter edit above the list (Ctrl+E)
 
 enum class ViewKind { Drives, Folder, Search };
 ViewKind g_view = ViewKind::Drives;
@@ -123,14 +137,41 @@ struct Row
     bool         isBrokenNetDrive;
     std::wstring netRemote; // \\server\share (best-effort)
 
+    // Search view: index into g_searchSnap.rows (-1 if not from the snapshot)
+    int          snapIdx;
+
+    // lower-cased name, filled on first use (quick filter, type-ahead)
+    std::wstring nameLower;
+
     Row() : isDir(false), size(0), vW(0), vH(0), vDur100ns(0),
-        isBrokenNetDrive(false)
+        isBrokenNetDrive(false), snapIdx(-1)
     {
         modified.dwLowDateTime = modified.dwHighDateTime = 0;
     }
 };
 std::vector<Row> g_rows;
 
+// The list is virtual (LVS_OWNERDATA): list item i shows g_rows[g_visible[i]].
+// g_visible holds the rows passing the quick filter, in g_rows order.
+std::vector<int> g_visible;
+std::wstring     g_filterLower;   // quick filter text applied to g_visible
+bool             g_filterShown = false;
+
+static Row* RowAt(int item)
+{
+    if (item < 0 || item >= (int)g_visible.size()) return nullptr;
+    return &g_rows[g_visible[item]];
+}
+
+// List item showing g_rows[rowIdx], or -1 if it is filtered out.
+static int ItemForRow(int rowIdx)
+{
+    if (g_visible.size() == g_rows.size()) return rowIdx; // unfiltered
+    auto it = std::lower_bound(g_visible.begin(), g_visible.end(), rowIdx);
+    if (it == g_visible.end() || *it != rowIdx) return -1;
+    return (int)(it - g_visible.begin());
+}
+
 // sorting
 int  g_sortCol = 0;      // 0=Name,1=Type,2=Size,3=Modified,4=Resolution,5=Duration
 bool g_sortAsc = true;
@@ -158,6 +199,19 @@ struct AppConfig
     // NEW: default credentials for network reconnect/map (optional)
     std::wstring netUsername;
     std::wstring netPassword;
+
+    // paste: number of parallel copy streams (1..16)
+    int copyStreams = 4;
+    // paste: files at least this many MB bypass the system cache (0 = never)
+    int unbufferedCopyMB = 2048;
+    // paste: hash while copying and compare against a re-read of the copy
+    bool copyVerify = false;
+    // background I/O budget while a video plays, MB/s (0 = priority only)
+    int playbackIoMBps = 40;
+    // network folders: seconds a stored listing is shown without revalidating
+    // (negative = not stored); per share via netCacheTtl.\\server\share or .x:
+    int netCacheTtl = 60;
+    std::map<std::wstring, int> netCacheTtlShare;   // lower-case share -> seconds
 };
 
 AppConfig g_cfg;
@@ -168,6 +222,10 @@ WINDOWPLACEMENT g_wpPrev;
 
 // timers
 const UINT_PTR kTimerPlaybackUI = 1;
+const UINT_PTR kTimerLiveSearch = 2;   // live search box: apply typed text
+const UINT_PTR kTimerJobsPanel = 3;    // jobs panel: refresh progress
+const UINT_PTR kTimerPrefetch = 4;     // focus rests on a folder row: prefetch it
+const UINT_PTR kTimerDriveProbe = 5;   // Drives view: probe deadline
 
 // post-playback actions
 enum class ActionType { DeleteFile, RenameFile, CopyToPath };
@@ -176,16 +234,18 @@ struct PostAction
     ActionType type;
     std::wstring src;
     std::wstring param;
+    int job = 0;           // running as this job (0: not started yet)
 };
 std::vector<PostAction> g_post;
 
-enum class OpResult { Success, Cancelled, Failed };
 
 // filename clipboard for browser
 enum class ClipMode { None, Copy, Move };
 ClipMode g_clipMode = ClipMode::None;
 std::vector<std::wstring> g_clipFiles; // absolute paths (files or dirs)
 
+// Per-volume folder deleted items are staged in (see TrashStage); never listed
+static const wchar_t kTrashDirName[] = L".browse-trash";
 
 // Make a file or directory writable so DeleteFile/RemoveDirectory will work.
 static void ClearReadonlyAndSystem(const std::wstring& path)
@@ -319,12 +379,20 @@ static bool GetClipboardFileDrop(std::vector<std::wstring>& outFiles, ClipMode*
 
 // ----------------------------- Search state (for videos only, as original)
 
+// Words: every space-separated term is a substring of the name (AND).
+// Fuzzy: ranked subsequence / typo-tolerant match of the whole query.
+// Glob: whole name against * ? [..] (like dir). Regex: search anywhere.
+enum class SearchMode { Words, Fuzzy, Glob, Regex };
+
 struct SearchState
 {
     bool active;
     ViewKind originView;
     std::wstring originFolder;
-    std::vector<std::wstring> termsLower;
+    SearchMode mode;
+    std::wstring query;                   // as typed
+    std::wstring queryLower;
+    std::vector<std::wstring> termsLower; // Words mode: queryLower split
 
     bool useExplicitScope;
     std::vector<std::wstring> explicitFolders;
@@ -333,6 +401,7 @@ struct SearchState
     SearchState()
         : active(false),
           originView(ViewKind::Drives),
+          mode(SearchMode::Words),
           useExplicitScope(false)
     {
     }
@@ -354,6 +423,8 @@ std::atomic<uint32_t> g_metaGen{ 0 };
 CRITICAL_SECTION      g_metaLock;
 std::vector<std::wstring> g_metaTodoPaths;
 HANDLE                g_metaThread = NULL;
+bool                  g_metaWorkerLive = false;   // g_metaLock: a worker of g_metaWorkerGen runs
+uint32_t              g_metaWorkerGen = 0;
 
 // ----------------------------- Context-menu command IDs
 
@@ -395,8 +466,9 @@ static void CollectSelection(std::vector<std::wstring>& outFolders,
     int idx = -1;
     while ((idx = ListView_GetNextItem(g_hwndList, idx, LVNI_SELECTED)) != -1)
     {
-        if (idx < 0 || idx >= (int)g_rows.size()) continue;
-        const Row& r = g_rows[idx];
+        const Row* pr = RowAt(idx);
+        if (!pr) continue;
+        const Row& r = *pr;
         if (r.isDir)
         {
             outFolders.push_back(EnsureSlash(r.full));
@@ -458,6 +530,21 @@ static std::wstring Trim(const std::wstring& s)
     return s.substr(start, end - start);
 }
 
+// Splits a lower-cased query into its AND terms (whitespace separated).
+static void SplitTerms(const std::wstring& qLower, std::vector<std::wstring>& outTerms)
+{
+    outTerms.clear();
+    size_t i = 0;
+    while (i < qLower.size())
+    {
+        while (i < qLower.size() && iswspace(qLower[i])) ++i;
+        size_t j = i;
+        while (j < qLower.size() && !iswspace(qLower[j])) ++j;
+        if (j > i) outTerms.push_back(qLower.substr(i, j - i));
+        i = j;
+    }
+}
+
 // ----------------------------- Logging
 
 static void InitLoggingFromConfig()
@@ -669,7 +756,14 @@ static void SetTitlePlaying()
 
 static std::wstring JoinTermsForTitle()
 {
-    if (!g_search.active || g_search.termsLower.empty()) return L"";
+    if (!g_search.active) return L"";
+    if (g_search.mode == SearchMode::Fuzzy)
+        return L"~\"" + Trim(g_search.queryLower) + L"\"";
+    if (g_search.mode == SearchMode::Glob)
+        return L"glob \"" + g_search.query + L"\"";
+    if (g_search.mode == SearchMode::Regex)
+        return L"/" + g_search.query + L"/";
+    if (g_search.termsLower.empty()) return L"";
     std::wstring s = L"\"";
     s += g_search.termsLower[0];
     s += L"\"";
@@ -688,6 +782,12 @@ static void SetTitleFolderOrDrives()
     if (g_view == ViewKind::Drives) t += L"[Drives]";
     else if (g_view == ViewKind::Folder) t += EnsureSlash(g_folder);
     else t += L"Search - " + JoinTermsForTitle();
+    if (!g_filterLower.empty())
+    {
+        wchar_t buf[64];
+        swprintf_s(buf, L"  [filter: %zu of %zu]", g_visible.size(), g_rows.size());
+        t += buf;
+    }
     SetWindowTextW(g_hwndMain, t.c_str());
 }
 
@@ -966,6 +1066,37 @@ static void LoadConfigFromIni()
         {
             g_cfg.netPassword = val;
         }
+        else if (key == L"copystreams")
+        {
+            int n = _wtoi(val.c_str());
+            if (n >= 1 && n <= 16) g_cfg.copyStreams = n;
+        }
+        else if (key == L"copyverify")
+        {
+            std::wstring v = ToLower(val);
+            g_cfg.copyVerify =
+                (v == L"1" || v == L"true" || v == L"yes" || v == L"on" || v == L"y");
+        }
+        else if (key == L"playbackiombps")
+        {
+            int n = _wtoi(val.c_str());
+            if (n >= 0) g_cfg.playbackIoMBps = n;
+        }
+        else if (key == L"unbufferedcopymb")
+        {
+            int n = _wtoi(val.c_str());
+            if (n >= 0) g_cfg.unbufferedCopyMB = n;
+        }
+        else if (key == L"netcachettl")
+        {
+            g_cfg.netCacheTtl = _wtoi(val.c_str());
+        }
+        else if (key.compare(0, 12, L"netcachettl.") == 0 && key.size() > 12)
+        {
+            std::wstring share = key.substr(12);
+            while (share.size() > 2 && share.back() == L'\\') share.pop_back();
+            g_cfg.netCacheTtlShare[share] = _wtoi(val.c_str());
+        }
 
     }
     InitLoggingFromConfig();
@@ -997,7 +1128,12 @@ static void ShowHelp()
            L"  Enter / Double-click : Open folder / Open file\n"
            L"                         (video files play in the built-in player)\n"
            L"  Left / Backspace     : Up one folder (from drive root -> drives)\n"
-           L"  Column header click  : Sort by column (folders always first)\n\n";
+           L"  Right                : Back down into the folder you came up from\n"
+           L"  Column header click  : Sort by column (folders always first)\n"
+           L"  Type letters         : Jump to the next item whose name starts with them\n"
+           L"  Ctrl+E               : Filter the current folder by name (Esc clears)\n"
+           L"  Ctrl+F               : Search videos (results narrow as you type,\n"
+           L"                         Esc restores the previous view)\n\n";
 
     msg += L"FILES & FOLDERS\n"
            L"  F2                   : Rename selected file or folder\n"
@@ -1005,6 +1141,7 @@ static void ShowHelp()
            L"  Ctrl+C / Ctrl+X      : Copy / Cut selected files and folders\n"
            L"  Ctrl+V               : Paste into current folder\n"
            L"  Del                  : Delete selected items (permanently)\n"
+           L"  Ctrl+J               : Jobs panel (pause, cancel or retry pastes and deletes)\n"
            L"  Right-click          : Context menu (Open, Play video, Rename, Cut/Copy/Paste, Delete)\n\n";
 
     msg += L"VIDEO PLAYBACK\n"
@@ -1046,10 +1183,10 @@ static LRESULT HandleListCustomDraw(NMLVCUSTOMDRAW* cd)
 
     case CDDS_ITEMPREPAINT | CDDS_SUBITEM:
     {
-        int idx = (int)cd->nmcd.dwItemSpec;
-        if (g_view == ViewKind::Drives && idx >= 0 && idx < (int)g_rows.size())
+        const Row* r = RowAt((int)cd->nmcd.dwItemSpec);
+        if (g_view == ViewKind::Drives && r)
         {
-            if (g_rows[idx].isBrokenNetDrive)
+            if (r->isBrokenNetDrive)
             {
                 cd->clrText = RGB(200, 0, 0);
             }
@@ -1118,83 +1255,342 @@ static void LV_ResetColumns()
     ListView_InsertColumn(g_hwndList, 5, &c);
 }
 
-static void LV_Add(int rowIndex, const Row& r)
+// Text for one cell; the list is virtual so this runs on LVN_GETDISPINFO.
+static void LV_CellText(const Row& r, int col, std::wstring& out)
 {
+    out.clear();
+
     // Drives view: col0=Remote, col1=Drive
     if (g_view == ViewKind::Drives)
     {
-        LVITEMW it{};
-        it.mask = LVIF_TEXT | LVIF_PARAM;
-        it.iItem = rowIndex;
-        it.lParam = rowIndex;
+        if (col == 0) out = r.netRemote;
+        else if (col == 1) out = r.name;
+        return;
+    }
+
+    switch (col)
+    {
+    case 0:
+        out = r.name;
+        break;
+    case 1:
+        if (r.isDir)
+        {
+            out = L"Folder";
+        }
+        else
+        {
+            const wchar_t* ext = PathFindExtensionW(r.full.c_str());
+            out = (ext && *ext) ? ext : L"File";
+        }
+        break;
+    case 2:
+        if (!r.isDir) out = FormatSize(r.size);
+        break;
+    case 3:
+        if (r.modified.dwLowDateTime || r.modified.dwHighDateTime)
+            out = FormatFileTime(r.modified);
+        break;
+    case 4:
+        if (!r.isDir && (r.vW > 0 || r.vH > 0))
+        {
+            wchar_t buf[64];
+            swprintf_s(buf, L"%dx%d", r.vW, r.vH);
+            out = buf;
+        }
+        break;
+    case 5:
+        if (!r.isDir && r.vDur100ns > 0) out = FormatDuration100ns(r.vDur100ns);
+        break;
+    }
+}
 
-        const wchar_t* remoteText = r.netRemote.empty() ? L"" : r.netRemote.c_str();
-        it.pszText = const_cast<wchar_t*>(remoteText);
+static void HandleListGetDispInfo(NMLVDISPINFOW* di)
+{
+    if (!(di->item.mask & LVIF_TEXT) || !di->item.pszText || di->item.cchTextMax <= 0)
+        return;
 
-        ListView_InsertItem(g_hwndList, &it);
-        ListView_SetItemText(g_hwndList, rowIndex, 1, const_cast<wchar_t*>(r.name.c_str()));
+    const Row* r = RowAt(di->item.iItem);
+    if (!r)
+    {
+        di->item.pszText[0] = 0;
         return;
     }
+    std::wstring text;
+    LV_CellText(*r, di->item.iSubItem, text);
+    wcsncpy_s(di->item.pszText, di->item.cchTextMax, text.c_str(), _TRUNCATE);
+}
+
+// ----------------------------- Type-ahead (LVN_ODFINDITEM)
+
+// List items ordered by lower-cased name (ties by item), so every name starting
+// with a typed prefix lies in one run found by binary search. Rebuilt lazily
+// whenever g_visible changes (new listing, sort, filter).
+static std::vector<int> g_nameIndex;
+static bool             g_nameIndexDirty = true;
+
+// g_nameLevels[k]: g_nameIndex with each aligned block of 2^k positions sorted
+// by item, so "smallest item >= start" over any run takes O(log^2 n)
+static std::vector<std::vector<int>> g_nameLevels;
+
+static const std::wstring& RowNameLower(Row& r)
+{
+    if (r.nameLower.empty() && !r.name.empty()) r.nameLower = ToLower(r.name);
+    return r.nameLower;
+}
+
+static void EnsureNameIndex()
+{
+    if (!g_nameIndexDirty) return;
+
+    g_nameIndex.resize(g_visible.size());
+    for (int i = 0; i < (int)g_visible.size(); ++i)
+    {
+        g_nameIndex[i] = i;
+        RowNameLower(g_rows[g_visible[i]]);
+    }
+    std::sort(g_nameIndex.begin(), g_nameIndex.end(), [](int a, int b)
+    {
+        int c = g_rows[g_visible[a]].nameLower.compare(g_rows[g_visible[b]].nameLower);
+        return c != 0 ? c < 0 : a < b;
+    });
+
+    const size_t n = g_nameIndex.size();
+    g_nameLevels.assign(1, g_nameIndex);
+    for (size_t w = 2; w / 2 < n; w *= 2)
+    {
+        const std::vector<int>& prev = g_nameLevels.back();
+        std::vector<int> cur(n);
+        for (size_t b = 0; b < n; b += w)
+        {
+            const size_t mid = std::min(b + w / 2, n), end = std::min(b + w, n);
+            std::merge(prev.begin() + b, prev.begin() + mid, prev.begin() + mid, prev.begin() + end,
+                       cur.begin() + b);
+        }
+        g_nameLevels.push_back(std::move(cur));
+    }
+    g_nameIndexDirty = false;
+}
+
+// Smallest item >= start among g_nameIndex positions [lo, hi); -1 if none
+static int NameIndex_FirstFrom(size_t lo, size_t hi, int start)
+{
+    int best = -1;
+    while (lo < hi)
+    {
+        // Largest aligned block that starts at lo and fits in the run
+        size_t k = 0;
+        while (k + 1 < g_nameLevels.size() && lo % ((size_t)2 << k) == 0 && lo + ((size_t)2 << k) <= hi) ++k;
+        const size_t end = lo + ((size_t)1 << k);
+
+        const std::vector<int>& lv = g_nameLevels[k];
+        auto it = std::lower_bound(lv.begin() + lo, lv.begin() + end, start);
+        if (it != lv.begin() + end && (best < 0 || *it < best)) best = *it;
+        lo = end;
+    }
+    return best;
+}
+
+// First item at or after 'start' (in display order) whose name starts with
+// prefixLower; wraps to the top if 'wrap'. -1 if nothing matches.
+static int TypeAhead_Find(const std::wstring& prefixLower, int start, bool wrap)
+{
+    if (prefixLower.empty() || g_visible.empty()) return -1;
+    EnsureNameIndex();
+
+    auto nameOf = [](int item) -> const std::wstring&
+    {
+        return g_rows[g_visible[item]].nameLower;
+    };
+    const size_t n = prefixLower.size();
+
+    auto lo = std::lower_bound(g_nameIndex.begin(), g_nameIndex.end(), prefixLower,
+                               [&](int item, const std::wstring& p)
+    {
+        return nameOf(item).compare(p) < 0;
+    });
+    auto hi = std::upper_bound(lo, g_nameIndex.end(), prefixLower,
+                               [&](const std::wstring& p, int item)
+    {
+        return nameOf(item).compare(0, n, p) > 0;
+    });
+    if (lo == hi) return -1;
+
+    // The run is in name order; pick the one nearest 'start' in display order
+    const size_t a = lo - g_nameIndex.begin(), b = hi - g_nameIndex.begin();
+    int after = NameIndex_FirstFrom(a, b, start);
+    if (after >= 0) return after;
+    return wrap ? NameIndex_FirstFrom(a, b, 0) : -1;
+}
+
+static LRESULT HandleListFindItem(NMLVFINDITEMW* fi)
+{
+    if (!(fi->lvfi.flags & (LVFI_STRING | LVFI_PARTIAL)) || !fi->lvfi.psz)
+        return -1;
+
+    int start = fi->iStart;
+    if (start < 0 || start >= (int)g_visible.size()) start = 0;
+    return TypeAhead_Find(ToLower(fi->lvfi.psz), start,
+                          (fi->lvfi.flags & LVFI_WRAP) != 0);
+}
+
+// ----------------------------- Quick filter (Ctrl+E)
 
-    // ---- Folder/Search view (your original behavior) ----
-    LVITEMW it{};
-    it.mask = LVIF_TEXT | LVIF_PARAM;
-    it.iItem = rowIndex;
-    it.pszText = const_cast<wchar_t*>(r.name.c_str());
-    it.lParam = rowIndex;
-    ListView_InsertItem(g_hwndList, &it);
+// Recompute g_visible from g_rows for g_filterLower. With narrowOnly the
+// filter text was only extended, so just re-check rows that already matched:
+// every old term is still a substring of some new term.
+static void RebuildVisible(bool narrowOnly)
+{
+    g_nameIndexDirty = true;
+
+    if (g_filterLower.empty())
+    {
+        g_visible.resize(g_rows.size());
+        for (int i = 0; i < (int)g_rows.size(); ++i) g_visible[i] = i;
+        return;
+    }
 
-    const wchar_t* typeText = L"Folder";
-    std::wstring typeBuf;
+    std::vector<std::wstring> terms;
+    SplitTerms(g_filterLower, terms);
 
-    if (!r.isDir)
+    auto matches = [&terms](Row& r) -> bool
     {
-        const wchar_t* ext = PathFindExtensionW(r.full.c_str());
-        if (ext && *ext)
+        const std::wstring& name = RowNameLower(r);
+        for (const auto& t : terms)
         {
-            typeBuf = ext;
-            typeText = typeBuf.c_str();
+            if (name.find(t) == std::wstring::npos) return false;
         }
-        else
+        return true;
+    };
+
+    if (narrowOnly)
+    {
+        size_t n = 0;
+        for (size_t k = 0; k < g_visible.size(); ++k)
         {
-            typeText = L"File";
+            if (matches(g_rows[g_visible[k]])) g_visible[n++] = g_visible[k];
         }
+        g_visible.resize(n);
+        return;
+    }
+
+    g_visible.clear();
+    for (int i = 0; i < (int)g_rows.size(); ++i)
+    {
+        if (matches(g_rows[i])) g_visible.push_back(i);
     }
+}
+
+// Push the current g_visible size to the list. Selection is by item index,
+// which no longer means the same row, so it is cleared.
+static void LV_SyncItemCount(bool keepScroll)
+{
+    ListView_SetItemState(g_hwndList, -1, 0, LVIS_SELECTED | LVIS_FOCUSED);
+    ListView_SetItemCountEx(g_hwndList, (int)g_visible.size(),
+                            keepScroll ? LVSICF_NOSCROLL : 0);
+    InvalidateRect(g_hwndList, NULL, TRUE);
+}
+
+static void LV_Rebuild()
+{
+    ListView_DeleteAllItems(g_hwndList);
+    RebuildVisible(false);
+    ListView_SetItemCountEx(g_hwndList, (int)g_visible.size(), 0);
+}
 
-    ListView_SetItemText(g_hwndList, rowIndex, 1, const_cast<wchar_t*>(typeText));
+static void OnSize(int cx, int cy);
 
-    if (!r.isDir)
+static void LayoutMain()
+{
+    RECT rc;
+    GetClientRect(g_hwndMain, &rc);
+    OnSize(rc.right, rc.bottom);
+}
+
+static void QuickFilter_Apply()
+{
+    int len = GetWindowTextLengthW(g_hwndFilter);
+    std::wstring text(len, L'\0');
+    if (len > 0) GetWindowTextW(g_hwndFilter, &text[0], len + 1);
+
+    std::wstring q = ToLower(text);
+    if (q == g_filterLower) return;
+
+    bool narrowOnly = !g_filterLower.empty() &&
+                      q.compare(0, g_filterLower.size(), g_filterLower) == 0;
+    g_filterLower = q;
+    RebuildVisible(narrowOnly);
+
+    LV_SyncItemCount(false);
+    if (!g_visible.empty())
     {
-        std::wstring s = FormatSize(r.size);
-        ListView_SetItemText(g_hwndList, rowIndex, 2, const_cast<wchar_t*>(s.c_str()));
+        ListView_SetItemState(g_hwndList, 0,
+                              LVIS_SELECTED | LVIS_FOCUSED,
+                              LVIS_SELECTED | LVIS_FOCUSED);
+        ListView_EnsureVisible(g_hwndList, 0, FALSE);
     }
-    if (r.modified.dwLowDateTime || r.modified.dwHighDateTime)
+    SetTitleFolderOrDrives();
+}
+
+// Drop the filter (all rows visible again) and hide the bar.
+static void QuickFilter_Clear()
+{
+    bool hadFilter = !g_filterLower.empty();
+    g_filterLower.clear();
+    if (g_hwndFilter) SetWindowTextW(g_hwndFilter, L"");
+    if (g_filterShown)
     {
-        std::wstring m = FormatFileTime(r.modified);
-        ListView_SetItemText(g_hwndList, rowIndex, 3, const_cast<wchar_t*>(m.c_str()));
+        g_filterShown = false;
+        ShowWindow(g_hwndFilter, SW_HIDE);
+        LayoutMain();
     }
-    if (!r.isDir && (r.vW > 0 || r.vH > 0))
+    if (hadFilter)
     {
-        wchar_t buf[64];
-        swprintf_s(buf, L"%dx%d", r.vW, r.vH);
-        ListView_SetItemText(g_hwndList, rowIndex, 4, buf);
+        RebuildVisible(false);
+        LV_SyncItemCount(true);
     }
-    if (!r.isDir && r.vDur100ns > 0)
+}
+
+static void QuickFilter_Show()
+{
+    if (g_view != ViewKind::Folder || g_inPlayback) return;
+    if (!g_filterShown)
     {
-        std::wstring ds = FormatDuration100ns(r.vDur100ns);
-        ListView_SetItemText(g_hwndList, rowIndex, 5, const_cast<wchar_t*>(ds.c_str()));
+        g_filterShown = true;
+        ShowWindow(g_hwndFilter, SW_SHOW);
+        LayoutMain();
     }
+    SetFocus(g_hwndFilter);
+    SendMessageW(g_hwndFilter, EM_SETSEL, 0, -1);
 }
 
-static void LV_Rebuild()
+static LRESULT CALLBACK FilterEditSub(HWND h, UINT m, WPARAM w, LPARAM l,
+                                      UINT_PTR, DWORD_PTR)
 {
-    ListView_DeleteAllItems(g_hwndList);
-    for (int i = 0; i < (int)g_rows.size(); ++i) LV_Add(i, g_rows[i]);
+    if (m == WM_GETDLGCODE) return DLGC_WANTALLKEYS;
+    if (m == WM_CHAR && (w == VK_RETURN || w == VK_ESCAPE)) return 0; // no beep
+    if (m == WM_KEYDOWN)
+    {
+        if (w == VK_ESCAPE)
+        {
+            QuickFilter_Clear();
+            SetTitleFolderOrDrives();
+            SetFocus(g_hwndList);
+            return 0;
+        }
+        if (w == VK_RETURN || w == VK_DOWN)
+        {
+            // Keep the filter, continue in the list
+            SetFocus(g_hwndList);
+            return 0;
+        }
+    }
+    return DefSubclassProc(h, m, w, l);
 }
 
 // ----------------------------- Sorting
 
-static void SortRows(int col, bool asc)
+static void SortRows(int col, bool asc, bool rebuild = true)
 {
     g_sortCol = col;
     g_sortAsc = asc;
@@ -1213,7 +1609,7 @@ static void SortRows(int col, bool asc)
             {
                 if (r.isDir) return L"Folder";
 
-                // Match what you display in LV_Add()
+                // Match what you display in LV_CellText()
                 if (IsVideoFile(r.full)) return L"Video";
 
                 const wchar_t* ext = PathFindExtensionW(r.full.c_str());
@@ -1259,145 +1655,748 @@ static void SortRows(int col, bool asc)
             return _wcsicmp(A.name.c_str(), B.name.c_str()) < 0;
         }
     });
-    LV_Rebuild();
+    if (rebuild) LV_Rebuild();
 }
 
-// ----------------------------- Async metadata worker
+// ----------------------------- I/O scheduler (per device)
 
-static DWORD WINAPI MetaThreadProc(LPVOID)
-{
-    CoInitializeEx(NULL, COINIT_APARTMENTTHREADED);
-    const uint32_t myGen = g_metaGen.load(std::memory_order_relaxed);
+// Background I/O (copy workers, the metadata probe) takes a slot on the
+// physical device a path lives on before touching it. Each device gets a
+// concurrency limit by media type, so two jobs on one spinning disk take
+// turns instead of seeking against each other, while an NVMe drive still
+// runs several streams. Waiters are served in arrival order.
 
-    for (;;)
-    {
-        std::wstring path;
-        EnterCriticalSection(&g_metaLock);
-        if (!g_metaTodoPaths.empty())
-        {
-            path = g_metaTodoPaths.back();
-            g_metaTodoPaths.pop_back();
-        }
-        LeaveCriticalSection(&g_metaLock);
+enum class IoMedia { Unknown, Hdd, Ssd, Nvme, Network };
 
-        if (path.empty()) break;
-        if (myGen != g_metaGen.load(std::memory_order_relaxed)) break;
+struct IoDevice
+{
+    std::wstring id;                  // "disk:0", "net:server", ...
+    IoMedia media = IoMedia::Unknown;
+    int limit = 2;
+    int active = 0;
+    std::deque<ULONGLONG> waiting;    // tickets, oldest first
+};
 
-        int w = 0, h = 0;
-        ULONGLONG d = 0;
-        GetVideoProps(path, w, h, d);
-        MetaResult* r = new MetaResult{ path, w, h, d, myGen };
-        PostMessageW(g_hwndMain, WM_APP_META, 0, (LPARAM)r);
+static int IoLimitFor(IoMedia m)
+{
+    switch (m)
+    {
+    case IoMedia::Hdd:     return 1;
+    case IoMedia::Ssd:     return 4;
+    case IoMedia::Nvme:    return 8;
+    case IoMedia::Network: return 4;
+    default:               return 2;
     }
-
-    CoUninitialize();
-    return 0;
 }
 
-static void StartMetaWorker()
+static const wchar_t* IoMediaName(IoMedia m)
 {
-    if (g_metaThread)
+    switch (m)
     {
-        CloseHandle(g_metaThread);
-        g_metaThread = NULL;
+    case IoMedia::Hdd:     return L"hdd";
+    case IoMedia::Ssd:     return L"ssd";
+    case IoMedia::Nvme:    return L"nvme";
+    case IoMedia::Network: return L"network";
+    default:               return L"unknown";
     }
-    g_metaThread = CreateThread(NULL, 0, MetaThreadProc, NULL, 0, NULL);
 }
 
-static void CancelMetaWorkAndClearTodo()
+static IoMedia QueryDiskMedia(DWORD disk)
 {
-    g_metaGen.fetch_add(1, std::memory_order_relaxed);
-    EnterCriticalSection(&g_metaLock);
-    g_metaTodoPaths.clear();
-    LeaveCriticalSection(&g_metaLock);
+    wchar_t name[64];
+    swprintf_s(name, L"\\\\.\\PhysicalDrive%lu", disk);
+    // No access rights needed for property queries
+    HANDLE h = CreateFileW(name, 0, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, 0, NULL);
+    if (h == INVALID_HANDLE_VALUE) return IoMedia::Unknown;
+
+    IoMedia media = IoMedia::Unknown;
+    DWORD br = 0;
+    STORAGE_PROPERTY_QUERY q{};
+    q.PropertyId = StorageDeviceSeekPenaltyProperty;
+    q.QueryType = PropertyStandardQuery;
+    DEVICE_SEEK_PENALTY_DESCRIPTOR sp{};
+    if (DeviceIoControl(h, IOCTL_STORAGE_QUERY_PROPERTY, &q, sizeof(q), &sp, sizeof(sp), &br, NULL) &&
+            br >= sizeof(sp))
+    {
+        media = sp.IncursSeekPenalty ? IoMedia::Hdd : IoMedia::Ssd;
+    }
+    if (media == IoMedia::Ssd)
+    {
+        q.PropertyId = StorageDeviceProperty;
+        STORAGE_DEVICE_DESCRIPTOR dd{};
+        if (DeviceIoControl(h, IOCTL_STORAGE_QUERY_PROPERTY, &q, sizeof(q), &dd, sizeof(dd), &br, NULL) &&
+                dd.BusType == BusTypeNvme)
+        {
+            media = IoMedia::Nvme;
+        }
+    }
+    CloseHandle(h);
+    return media;
 }
 
-static void QueueMissingPropsAndKickWorker()
+CRITICAL_SECTION   g_ioLock;
+CONDITION_VARIABLE g_ioCv;
+std::map<std::wstring, IoDevice*> g_ioDevices;   // by device id (never freed)
+std::map<std::wstring, IoDevice*> g_ioVolumes;   // lower-case volume root/server -> device
+ULONGLONG          g_ioNextTicket = 0;
+
+static IoDevice* IoDeviceForPath(const std::wstring& path)
 {
-    EnterCriticalSection(&g_metaLock);
-    for (const auto& r : g_rows)
+    // Volume root, or \\server for UNC paths
+    std::wstring root;
+    bool unc = path.size() > 2 && path[0] == L'\\' && path[1] == L'\\' &&
+               path[2] != L'?' && path[2] != L'.';
+    if (unc)
     {
-        if (!r.isDir && r.vW == 0 && r.vH == 0 && r.vDur100ns == 0 && IsVideoFile(r.full))
+        root = path.substr(0, path.find(L'\\', 2));
+    }
+    else
+    {
+        wchar_t vp[MAX_PATH] {};
+        if (!GetVolumePathNameW(path.c_str(), vp, MAX_PATH)) return nullptr;
+        root = vp;
+    }
+    const std::wstring key = ToLower(root);
+
+    EnterCriticalSection(&g_ioLock);
+    auto hit = g_ioVolumes.find(key);
+    IoDevice* dev = hit != g_ioVolumes.end() ? hit->second : nullptr;
+    LeaveCriticalSection(&g_ioLock);
+    if (dev) return dev;
+
+    // Detect outside the lock; the IOCTLs can take a moment
+    std::wstring id;
+    IoMedia media = IoMedia::Unknown;
+    if (unc || GetDriveTypeW(root.c_str()) == DRIVE_REMOTE)
+    {
+        // One device per server, whether reached by UNC path or mapped drive
+        std::wstring server = key;
+        wchar_t remote[MAX_PATH] {};
+        DWORD len = MAX_PATH;
+        if (!unc && WNetGetConnectionW(root.substr(0, 2).c_str(), remote, &len) == NO_ERROR &&
+                remote[0] == L'\\' && remote[1] == L'\\')
         {
-            g_metaTodoPaths.push_back(r.full);
+            server = ToLower(remote);
+            server = server.substr(0, server.find(L'\\', 2));
+        }
+        id = L"net:" + server;
+        media = IoMedia::Network;
+    }
+    else
+    {
+        id = L"vol:" + key;
+        wchar_t vol[MAX_PATH] {};
+        if (GetVolumeNameForVolumeMountPointW(root.c_str(), vol, MAX_PATH))
+        {
+            std::wstring v = vol;
+            if (!v.empty() && v.back() == L'\\') v.pop_back();
+            HANDLE h = CreateFileW(v.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                   NULL, OPEN_EXISTING, 0, NULL);
+            if (h != INVALID_HANDLE_VALUE)
+            {
+                VOLUME_DISK_EXTENTS ext{};
+                DWORD br = 0;
+                // Spanned volumes report MORE_DATA; the first disk is enough
+                if (DeviceIoControl(h, IOCTL_VOLUME_GET_VOLUME_DISK_EXTENTS, NULL, 0,
+                                    &ext, sizeof(ext), &br, NULL) || GetLastError() == ERROR_MORE_DATA)
+                {
+                    if (ext.NumberOfDiskExtents > 0)
+                    {
+                        id = L"disk:" + std::to_wstring(ext.Extents[0].DiskNumber);
+                        media = QueryDiskMedia(ext.Extents[0].DiskNumber);
+                    }
+                }
+                CloseHandle(h);
+            }
         }
     }
-    LeaveCriticalSection(&g_metaLock);
-    if (!g_metaTodoPaths.empty()) StartMetaWorker();
-}
 
-// ----------------------------- Populate views
+    EnterCriticalSection(&g_ioLock);
+    auto known = g_ioDevices.find(id);
+    bool created = (known == g_ioDevices.end());
+    if (created)
+    {
+        dev = new IoDevice;
+        dev->id = id;
+        dev->media = media;
+        dev->limit = IoLimitFor(media);
+        g_ioDevices[id] = dev;
+    }
+    else
+    {
+        dev = known->second;
+    }
+    g_ioVolumes[key] = dev;
+    LeaveCriticalSection(&g_ioLock);
 
-static void ShowDrives()
+    if (created)
+        LogLine(L"IoSched: %s -> %s (%s, %d at a time)", root.c_str(), id.c_str(),
+                IoMediaName(media), dev->limit);
+    return dev;
+}
+
+// Wait for a slot; false if cancel was raised first.
+static bool IoAcquire(IoDevice* d, const std::atomic<bool>* cancel)
 {
-    CancelMetaWorkAndClearTodo();
+    EnterCriticalSection(&g_ioLock);
+    const ULONGLONG ticket = g_ioNextTicket++;
+    d->waiting.push_back(ticket);
+    while (d->waiting.front() != ticket || d->active >= d->limit)
+    {
+        if (cancel && cancel->load(std::memory_order_relaxed))
+        {
+            d->waiting.erase(std::find(d->waiting.begin(), d->waiting.end(), ticket));
+            LeaveCriticalSection(&g_ioLock);
+            WakeAllConditionVariable(&g_ioCv);
+            return false;
+        }
+        SleepConditionVariableCS(&g_ioCv, &g_ioLock, 100);
+    }
+    d->waiting.pop_front();
+    ++d->active;
+    LeaveCriticalSection(&g_ioLock);
+    WakeAllConditionVariable(&g_ioCv); // the next in line may fit as well
+    return true;
+}
 
-    g_view = ViewKind::Drives;
-    g_folder.clear();
-    g_rows.clear();
+static void IoRelease(IoDevice* d)
+{
+    EnterCriticalSection(&g_ioLock);
+    --d->active;
+    LeaveCriticalSection(&g_ioLock);
+    WakeAllConditionVariable(&g_ioCv);
+}
 
-    SendMessageW(g_hwndList, WM_SETREDRAW, FALSE, 0);
-    LV_ResetColumns();
+// Slots on up to two devices (source and destination of a copy). Devices are
+// always taken in the same order, so two holders cannot deadlock.
+struct IoSlot
+{
+    IoDevice* dev[2] = {};
+    bool ok = true;
+    const std::atomic<bool>* cancel = nullptr;
+    const std::atomic<bool>* paused = nullptr;   // holder's pause flag, see Checkpoint
 
-    // Get currently-connected mapped drives (like "net use" Status=OK)
-    std::wstring remoteByLetter[26];
-    DWORD connectedMask = GetConnectedNetDriveMaskAndRemotes(remoteByLetter);
+    IoSlot(IoDevice* a, IoDevice* b, const std::atomic<bool>* cancel_) : cancel(cancel_)
+    {
+        if (a == b) b = nullptr;
+        if (a && b && std::less<IoDevice*>()(b, a)) std::swap(a, b);
+        Take(a, b);
+    }
+    ~IoSlot()
+    {
+        Release();
+    }
 
-    DWORD mask = GetLogicalDrives();
-    for (int i = 0; i < 26; ++i)
+    // Between blocks of a long transfer: while the holder is paused its
+    // devices go to whoever waits for them, and are queued for again after.
+    // False if cancelled (the slot may then hold nothing).
+    bool Checkpoint()
     {
-        if (!(mask & (1u << i))) continue;
+        if (!paused || !paused->load(std::memory_order_relaxed)) return ok;
+        IoDevice* a = dev[0];
+        IoDevice* b = dev[1];
+        Release();
+        while (paused->load(std::memory_order_relaxed) &&
+                !(cancel && cancel->load(std::memory_order_relaxed)))
+            Sleep(100);
+        if (cancel && cancel->load(std::memory_order_relaxed)) return ok = false;
+        Take(a, b);
+        return ok;
+    }
 
-        wchar_t letter = (wchar_t)(L'A' + i);
-        wchar_t root[4] = { letter, L':', L'\\', 0 };
+    void Take(IoDevice* a, IoDevice* b)
+    {
+        if (a && !(ok = IoAcquire(a, cancel))) return;
+        dev[0] = a;
+        if (b && !(ok = IoAcquire(b, cancel))) return;
+        dev[1] = b;
+    }
+    void Release()
+    {
+        for (IoDevice*& d : dev)
+        {
+            if (d) IoRelease(d);
+            d = nullptr;
+        }
+    }
+    IoSlot(const IoSlot&) = delete;
+    IoSlot& operator=(const IoSlot&) = delete;
+};
 
-        // NEW: hide optical drives (CD/DVD/BD)
-        UINT dt = GetDriveTypeW(root);
-        if (dt == DRIVE_CDROM)
-            continue;
+// ----------------------------- Background I/O governor
 
-        Row r;
-        r.full = root;
-        r.isDir = true;
-        r.name = root; // displayed in Drive column
+// While a video plays, background jobs yield to it: their threads drop to
+// background (very low) I/O priority and all of them share one byte budget,
+// browse.ini playbackIoMBps. When libVLC reports buffering the budget falls
+// to an eighth and then doubles every second after buffering has cleared,
+// back up to the cap.
 
-        // Connected mapping remote (best match to "net use")
-        if (!remoteByLetter[i].empty())
-            r.netRemote = remoteByLetter[i];
+static const double kGovBackoffDiv = 8.0;
+static const double kMetaProbeBytes = 1 << 20;   // budget charged per metadata probe
 
-        // Persistent mapping (exists even if disconnected)
-        std::wstring persistentRemote;
-        bool hasPersistent = GetPersistentMappedRemotePath(letter, persistentRemote);
-        bool isConnected = ((connectedMask & (1u << i)) != 0);
+std::atomic<bool>      g_govPlayback{ false };
+std::atomic<bool>      g_govBuffering{ false };
+std::atomic<ULONGLONG> g_govBufferingEnd{ 0 };   // tick buffering last cleared
+
+CRITICAL_SECTION g_govLock;
+double           g_govTokens = 0.0;               // bytes; negative = debt
+ULONGLONG        g_govRefillTick = 0;
+
+static void IoGovernor_SetPlayback(bool on)
+{
+    g_govPlayback.store(on, std::memory_order_relaxed);
+    if (!on) g_govBuffering.store(false, std::memory_order_relaxed);
+}
+
+// libVLC event thread
+static void IoGovernor_OnBuffering(float percent)
+{
+    bool now = percent < 100.0f;
+    if (g_govBuffering.exchange(now, std::memory_order_relaxed) == now) return;
+    if (!now) g_govBufferingEnd.store(GetTickCount64(), std::memory_order_relaxed);
+    LogLine(L"IoGovernor: playback %s", now ? L"buffering, backing off" : L"buffered, recovering");
+}
+
+// Background bytes per second allowed right now; 0 = unlimited.
+static double IoGovernor_Rate()
+{
+    if (!g_govPlayback.load(std::memory_order_relaxed) || g_cfg.playbackIoMBps <= 0) return 0.0;
+    const double cap = g_cfg.playbackIoMBps * 1048576.0;
+    const double floor = cap / kGovBackoffDiv;
+    if (g_govBuffering.load(std::memory_order_relaxed)) return floor;
+
+    ULONGLONG since = GetTickCount64() - g_govBufferingEnd.load(std::memory_order_relaxed);
+    if (since >= 3000) return cap; // 2^3 = kGovBackoffDiv
+    return std::min(cap, floor * pow(2.0, since / 1000.0));
+}
+
+// Charge `bytes` of background I/O; sleeps while over budget. False if
+// cancel was raised while waiting.
+static bool IoGovernor_Throttle(double bytes, const std::atomic<bool>* cancel)
+{
+    double rate = IoGovernor_Rate();
+    if (rate <= 0.0) return true;
+
+    EnterCriticalSection(&g_govLock);
+    ULONGLONG now = GetTickCount64();
+    if (g_govRefillTick == 0) g_govRefillTick = now;
+    g_govTokens = std::min(rate, g_govTokens + rate * (now - g_govRefillTick) / 1000.0); // <= 1 s burst
+    g_govRefillTick = now;
+    g_govTokens -= bytes;
+    DWORD waitMs = g_govTokens < 0 ? (DWORD)(-g_govTokens * 1000.0 / rate) : 0;
+    LeaveCriticalSection(&g_govLock);
+
+    while (waitMs > 0)
+    {
+        if (cancel && cancel->load(std::memory_order_relaxed)) return false;
+        DWORD step = std::min<DWORD>(waitMs, 50);
+        Sleep(step);
+        waitMs -= step;
+        if (IoGovernor_Rate() <= 0.0) break; // playback ended
+    }
+    return true;
+}
+
+// Per worker thread: background I/O priority while a video plays.
+static void IoGovernor_ThreadMode(bool& background)
+{
+    bool want = g_govPlayback.load(std::memory_order_relaxed);
+    if (want == background) return;
+    SetThreadPriority(GetCurrentThread(), want ? THREAD_MODE_BACKGROUND_BEGIN : THREAD_MODE_BACKGROUND_END);
+    background = want;
+}
+
+// ----------------------------- Async metadata worker
 
-        // If not currently connected but persistent exists, still show the remote
-        if (r.netRemote.empty() && hasPersistent)
-            r.netRemote = persistentRemote;
+static DWORD WINAPI MetaThreadProc(LPVOID param)
+{
+    CoInitializeEx(NULL, COINIT_APARTMENTTHREADED);
+    const uint32_t myGen = (uint32_t)(UINT_PTR)param;
+    bool background = false;
 
-        // Preserve your "broken mapped drive" behavior (red + block activate)
-        if (hasPersistent && !isConnected)
+    for (;;)
+    {
+        std::wstring path;
+        EnterCriticalSection(&g_metaLock);
+        const bool current = (myGen == g_metaGen.load(std::memory_order_relaxed));
+        if (current && !g_metaTodoPaths.empty())
+        {
+            path = g_metaTodoPaths.back();
+            g_metaTodoPaths.pop_back();
+        }
+        else if (current && g_metaWorkerGen == myGen)
         {
-            r.isBrokenNetDrive = true;
-            r.netRemote = persistentRemote;
+            g_metaWorkerLive = false;   // paths queued from now on start a new worker
+        }
+        LeaveCriticalSection(&g_metaLock);
+
+        if (path.empty()) break;
 
-            // Display as "X:" (no trailing slash) per your request
-            r.name.clear();
-            r.name.push_back(letter);
-            r.name.push_back(L':');
+        int w = 0, h = 0;
+        ULONGLONG d = 0;
+        IoGovernor_ThreadMode(background);
+        IoGovernor_Throttle(kMetaProbeBytes, nullptr);
+        {
+            IoSlot slot(IoDeviceForPath(path), nullptr, nullptr);
+            GetVideoProps(path, w, h, d);
         }
+        MetaResult* r = new MetaResult{ path, w, h, d, myGen };
+        PostMessageW(g_hwndMain, WM_APP_META, 0, (LPARAM)r);
+    }
 
-        g_rows.push_back(std::move(r));
+    CoUninitialize();
+    return 0;
+}
+
+// One worker per generation; paths queued while it runs are picked up by it
+static void StartMetaWorker()
+{
+    const uint32_t gen = g_metaGen.load(std::memory_order_relaxed);
+    EnterCriticalSection(&g_metaLock);
+    const bool running = g_metaWorkerLive && g_metaWorkerGen == gen;
+    g_metaWorkerLive = true;
+    g_metaWorkerGen = gen;
+    LeaveCriticalSection(&g_metaLock);
+    if (running) return;
+
+    if (g_metaThread)
+    {
+        CloseHandle(g_metaThread);
+        g_metaThread = NULL;
+    }
+    g_metaThread = CreateThread(NULL, 0, MetaThreadProc, (LPVOID)(UINT_PTR)gen, 0, NULL);
+    if (!g_metaThread)
+    {
+        EnterCriticalSection(&g_metaLock);
+        g_metaWorkerLive = false;
+        LeaveCriticalSection(&g_metaLock);
     }
+}
 
-    // Keep alphabetical by drive letter (do NOT touch g_sortCol used by folder view)
-    std::sort(g_rows.begin(), g_rows.end(),
-        [](const Row& a, const Row& b)
+static void CancelMetaWorkAndClearTodo()
+{
+    g_metaGen.fetch_add(1, std::memory_order_relaxed);
+    EnterCriticalSection(&g_metaLock);
+    g_metaTodoPaths.clear();
+    LeaveCriticalSection(&g_metaLock);
+}
+
+static void QueueMissingPropsAndKickWorker()
+{
+    EnterCriticalSection(&g_metaLock);
+    for (const auto& r : g_rows)
+    {
+        if (!r.isDir && r.vW == 0 && r.vH == 0 && r.vDur100ns == 0 && IsVideoFile(r.full))
         {
-            wchar_t ca = a.full.empty() ? 0 : (wchar_t)towupper(a.full[0]);
-            wchar_t cb = b.full.empty() ? 0 : (wchar_t)towupper(b.full[0]);
-            if (ca != cb) return ca < cb;
-            return _wcsicmp(a.name.c_str(), b.name.c_str()) < 0;
-        });
+            g_metaTodoPaths.push_back(r.full);
+        }
+    }
+    LeaveCriticalSection(&g_metaLock);
+    if (!g_metaTodoPaths.empty()) StartMetaWorker();
+}
+
+// Queue props for just these files (rows added to a view already shown)
+static void QueueMetaPaths(const std::vector<std::wstring>& paths)
+{
+    if (paths.empty()) return;
+    EnterCriticalSection(&g_metaLock);
+    g_metaTodoPaths.insert(g_metaTodoPaths.end(), paths.begin(), paths.end());
+    LeaveCriticalSection(&g_metaLock);
+    StartMetaWorker();
+}
+
+// One folder-view row from its directory entry (withProps: fast video props)
+static Row MakeFolderRow(const std::wstring& folder, const WIN32_FIND_DATAW& fd, bool withProps = true)
+{
+    Row r;
+    r.name = fd.cFileName;
+    r.full = folder + fd.cFileName;
+    r.isDir = (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+    r.modified = fd.ftLastWriteTime;
+    if (r.isDir) return r;
+
+    ULARGE_INTEGER uli;
+    uli.HighPart = fd.nFileSizeHigh;
+    uli.LowPart = fd.nFileSizeLow;
+    r.size = uli.QuadPart;
+    if (withProps && IsVideoFile(r.full) && !GetVideoPropsFastCached(r.full, r.vW, r.vH, r.vDur100ns))
+    {
+        r.vW = r.vH = 0;
+        r.vDur100ns = 0;
+    }
+    return r;
+}
+
+// ----------------------------- Live folder refresh
+//
+// The folder on screen is watched with ReadDirectoryChangesW on a thread of
+// its own. Changes are gathered for kWatchSettleMs; the watch thread then
+// re-reads only the names that changed and posts the finished rows to the UI
+// thread, which patches g_rows in place (FolderWatch_Apply): no
+// re-enumeration, and selection and scroll stay put. Video properties are
+// filled in afterwards by the meta worker. Only an overflowed change buffer
+// falls back to reading the whole folder again.
+
+constexpr UINT WM_APP_FSCHANGE = WM_APP + 102;   // wParam: watch generation, lParam: FsChangeBatch*
+static const DWORD kWatchSettleMs = 200;
+static const DWORD kWatchBufBytes = 64 * 1024;   // network shares refuse more
+
+struct FsChangeBatch
+{
+    std::vector<std::wstring> names;   // entries that changed, as reported (may repeat)
+    std::vector<Row> rows;             // changed entries that exist, re-read (no props)
+    std::vector<std::wstring> gone;    // full paths of changed entries that no longer exist
+    bool overflow = false;             // too many changes: re-read everything
+};
+
+// Watch thread: re-read the names a batch reported, once each
+static void FsChangeBatch_Stat(FsChangeBatch& b, const std::wstring& folder, HANDLE stop)
+{
+    std::unordered_set<std::wstring> seen;
+    for (const auto& name : b.names)
+    {
+        if (WaitForSingleObject(stop, 0) == WAIT_OBJECT_0) return;
+        if (!seen.insert(ToLower(name)).second) continue;
+        if (name.find(L'\\') != std::wstring::npos || _wcsicmp(name.c_str(), kTrashDirName) == 0)
+            continue;
+
+        const std::wstring full = folder + name;
+        WIN32_FIND_DATAW fd;
+        HANDLE h = FindFirstFileExW(full.c_str(), FindExInfoBasic, &fd,
+                                    FindExSearchNameMatch, NULL, 0);
+        if (h == INVALID_HANDLE_VALUE)
+        {
+            b.gone.push_back(full);
+            continue;
+        }
+        FindClose(h);
+        b.rows.push_back(MakeFolderRow(folder, fd, false));
+    }
+}
+
+struct FolderWatch
+{
+    HANDLE thread = NULL;
+    HANDLE stop = NULL;                // manual-reset event
+    std::wstring folder;
+    unsigned gen = 0;
+} g_watch;
+
+static unsigned g_watchGen = 0;                   // UI thread
+static std::atomic<unsigned> g_watchLiveGen{ 0 };  // generation whose watch is running
+
+struct FolderWatchArgs
+{
+    std::wstring folder;
+    unsigned gen;
+    HANDLE stop;
+};
+
+static DWORD WINAPI FolderWatchProc(LPVOID p)
+{
+    std::unique_ptr<FolderWatchArgs> a((FolderWatchArgs*)p);
+    HANDLE dir = CreateFileW(a->folder.c_str(), FILE_LIST_DIRECTORY,
+                             FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+                             OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+    if (dir == INVALID_HANDLE_VALUE)
+    {
+        LogLine(L"FolderWatch: cannot watch \"%s\" (error %lu)", a->folder.c_str(), GetLastError());
+        return 0;
+    }
+
+    const DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME |
+                         FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE;
+    std::vector<DWORD> buf(kWatchBufBytes / sizeof(DWORD));   // DWORD-aligned
+    OVERLAPPED ov{};
+    ov.hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+
+    FsChangeBatch* pending = nullptr;
+    ULONGLONG deadline = 0;
+    bool reading = false, failed = false;
+    for (;;)
+    {
+        if (!reading)
+        {
+            ResetEvent(ov.hEvent);
+            if (!ReadDirectoryChangesW(dir, buf.data(), kWatchBufBytes, FALSE, filter, NULL, &ov, NULL))
+            {
+                LogLine(L"FolderWatch: \"%s\" not supported (error %lu)", a->folder.c_str(), GetLastError());
+                failed = true;
+                break;
+            }
+            reading = true;
+            g_watchLiveGen = a->gen;
+        }
+
+        DWORD wait = INFINITE;
+        if (pending)
+        {
+            ULONGLONG now = GetTickCount64();
+            wait = now >= deadline ? 0 : (DWORD)(deadline - now);
+        }
+        HANDLE hs[2] = { a->stop, ov.hEvent };
+        DWORD w = WaitForMultipleObjects(2, hs, FALSE, wait);
+        if (w == WAIT_OBJECT_0) break;
+
+        if (w == WAIT_OBJECT_0 + 1)
+        {
+            reading = false;
+            if (!pending)
+            {
+                pending = new FsChangeBatch;
+                deadline = GetTickCount64() + kWatchSettleMs;
+            }
+            DWORD got = 0;
+            if (!GetOverlappedResult(dir, &ov, &got, FALSE))
+            {
+                // The folder itself went away or the share dropped
+                pending->overflow = true;
+                deadline = 0;
+                continue;
+            }
+            if (got == 0)
+            {
+                pending->overflow = true;
+                continue;
+            }
+            const BYTE* at = (const BYTE*)buf.data();
+            for (;;)
+            {
+                const FILE_NOTIFY_INFORMATION* fni = (const FILE_NOTIFY_INFORMATION*)at;
+                pending->names.push_back(std::wstring(fni->FileName, fni->FileNameLength / sizeof(WCHAR)));
+                if (!fni->NextEntryOffset) break;
+                at += fni->NextEntryOffset;
+            }
+            continue;
+        }
+
+        if (pending)
+        {
+            if (!pending->overflow) FsChangeBatch_Stat(*pending, a->folder, a->stop);
+            if (!PostMessageW(g_hwndMain, WM_APP_FSCHANGE, (WPARAM)a->gen, (LPARAM)pending))
+                delete pending;
+            pending = nullptr;
+        }
+    }
+
+    unsigned live = a->gen;
+    g_watchLiveGen.compare_exchange_strong(live, 0);
+    if (reading)
+    {
+        DWORD got = 0;
+        CancelIoEx(dir, &ov);
+        GetOverlappedResult(dir, &ov, &got, TRUE);
+    }
+    // The watch died with changes pending (the folder went away): read it again
+    if (failed && pending)
+    {
+        pending->overflow = true;
+        if (PostMessageW(g_hwndMain, WM_APP_FSCHANGE, (WPARAM)a->gen, (LPARAM)pending)) pending = nullptr;
+    }
+    delete pending;
+    CloseHandle(ov.hEvent);
+    CloseHandle(dir);
+    return 0;
+}
+
+static void FolderWatch_Stop()
+{
+    ++g_watchGen; // batches already posted are dropped
+    if (g_watch.thread)
+    {
+        SetEvent(g_watch.stop);
+        // A watch stuck opening a dead share keeps its handles
+        if (WaitForSingleObject(g_watch.thread, 2000) == WAIT_OBJECT_0)
+            CloseHandle(g_watch.stop);
+        CloseHandle(g_watch.thread);
+    }
+    g_watch = FolderWatch();
+}
+
+static void FolderWatch_Start(const std::wstring& folder)
+{
+    if (g_watch.thread && _wcsicmp(g_watch.folder.c_str(), folder.c_str()) == 0) return;
+    FolderWatch_Stop();
+
+    g_watch.folder = folder;
+    g_watch.gen = g_watchGen;
+    g_watch.stop = CreateEventW(NULL, TRUE, FALSE, NULL);
+    FolderWatchArgs* a = new FolderWatchArgs{ folder, g_watch.gen, g_watch.stop };
+    g_watch.thread = CreateThread(NULL, 0, FolderWatchProc, a, 0, NULL);
+    if (!g_watch.thread)
+    {
+        delete a;
+        CloseHandle(g_watch.stop);
+        g_watch = FolderWatch();
+    }
+}
+
+// The current folder is being watched, so our own changes show up by themselves
+static bool FolderWatch_Live()
+{
+    return g_view == ViewKind::Folder && g_watch.thread &&
+           g_watchLiveGen.load() == g_watch.gen && g_watch.gen == g_watchGen;
+}
+
+// ----------------------------- Populate views
+
+static void NavCache_Save();
+static void Drives_StartProbes(DWORD mask);
+static void NetCache_Store(const std::wstring& folder, const std::vector<Row>& rows,
+                           const FILETIME& stamp);
+static void NetCache_Drop(const std::wstring& folder);
+static int NetCache_Ttl(const std::wstring& folder);
+
+static FILETIME g_folderStamp{};   // last-write time of a network folder as listed (else zero)
+static ULONGLONG g_folderListedTick = 0; // when the shown folder was last listed in full
+static bool g_folderGone = false;   // the shown folder failed to list again: nothing to keep
+
+// Drive types by letter as the Drives view probes reported them (0: not known)
+static UINT g_driveTypeSeen[26] = {};
+
+// UNC path or mapped network drive. The drive type comes from the probes; a
+// drive never probed is asked once (it is being opened anyway)
+static bool IsNetworkFolder(const std::wstring& path)
+{
+    if (path.compare(0, 2, L"\\\\") == 0) return path.compare(0, 4, L"\\\\?\\") != 0;
+    if (path.size() < 2 || path[1] != L':') return false;
+    const int d = (int)towupper(path[0]) - L'A';
+    if (d < 0 || d >= 26) return false;
+    if (g_driveTypeSeen[d] == DRIVE_UNKNOWN)
+    {
+        const wchar_t root[4] = { path[0], L':', L'\\', 0 };
+        g_driveTypeSeen[d] = GetDriveTypeW(root);
+    }
+    return g_driveTypeSeen[d] == DRIVE_REMOTE;
+}
+
+static void ShowDrives()
+{
+    NavCache_Save();
+    CancelMetaWorkAndClearTodo();
+    QuickFilter_Clear();
+    FolderWatch_Stop();
+
+    g_view = ViewKind::Drives;
+    g_folder.clear();
+    g_rows.clear();
+
+    SendMessageW(g_hwndList, WM_SETREDRAW, FALSE, 0);
+    LV_ResetColumns();
+
+    // Letters only; type, mapping and connection state arrive from Drives_StartProbes
+    DWORD mask = GetLogicalDrives();
+    for (int i = 0; i < 26; ++i)
+    {
+        if (!(mask & (1u << i))) continue;
+
+        wchar_t root[4] = { (wchar_t)(L'A' + i), L':', L'\\', 0 };
+        Row r;
+        r.full = root;
+        r.isDir = true;
+        r.name = root; // displayed in Drive column
+        g_rows.push_back(std::move(r));
+    }
 
     LV_Rebuild();
 
@@ -1405,20 +2404,33 @@ static void ShowDrives()
     InvalidateRect(g_hwndList, NULL, TRUE);
 
     SetTitleFolderOrDrives();
+    Drives_StartProbes(mask);
 }
 
 // Folder view: shows ALL files, not only videos.
 // Folder view: shows ALL files, not only videos.
 static void ShowFolder(std::wstring abs)
 {
+    NavCache_Save();
     CancelMetaWorkAndClearTodo();
 
     if (abs.size() == 2 && abs[1] == L':') abs += L'\\';
     abs = EnsureSlash(abs);
+    // Refreshing the same folder keeps the quick filter
+    if (g_view != ViewKind::Folder || _wcsicmp(abs.c_str(), g_folder.c_str()) != 0)
+        QuickFilter_Clear();
     g_view = ViewKind::Folder;
     g_folder = abs;
     g_rows.clear();
 
+    // Network listings are stored with the folder's last-write time
+    const bool net = IsNetworkFolder(abs);
+    WIN32_FILE_ATTRIBUTE_DATA dirAttrs{};
+    g_folderStamp = FILETIME{};
+    if (net && GetFileAttributesExW(abs.c_str(), GetFileExInfoStandard, &dirAttrs))
+        g_folderStamp = dirAttrs.ftLastWriteTime;
+    g_folderListedTick = GetTickCount64();
+
     // ------------------------------------------------------------
     // NEW: title update immediately + 1-char busy animation setup
     // Sequence: ' ' '.' 'o' 'O' ' ' ...
@@ -1459,6 +2471,7 @@ static void ShowFolder(std::wstring abs)
         g_loadingFolder = false;
 
         SetTitleFolderOrDrives(); // ends cleanly (no spinner char)
+        FolderWatch_Start(g_folder);
         return;
     }
 
@@ -1466,34 +2479,11 @@ static void ShowFolder(std::wstring abs)
     do
     {
         if (wcscmp(fd.cFileName, L".") == 0 || wcscmp(fd.cFileName, L"..") == 0) continue;
+        if (_wcsicmp(fd.cFileName, kTrashDirName) == 0) continue;
 
-        Row r;
-        r.name = fd.cFileName;
-        r.full = abs + fd.cFileName;
-        r.isDir = (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
-        r.modified = fd.ftLastWriteTime;
-
-        if (r.isDir)
-        {
-            dirs.push_back(r);
-        }
-        else
-        {
-            ULARGE_INTEGER uli;
-            uli.HighPart = fd.nFileSizeHigh;
-            uli.LowPart = fd.nFileSizeLow;
-            r.size = uli.QuadPart;
-
-            if (IsVideoFile(r.full))
-            {
-                if (!GetVideoPropsFastCached(r.full, r.vW, r.vH, r.vDur100ns))
-                {
-                    r.vW = r.vH = 0;
-                    r.vDur100ns = 0;
-                }
-            }
-            files.push_back(r);
-        }
+        Row r = MakeFolderRow(abs, fd);
+        if (r.isDir) dirs.push_back(r);
+        else files.push_back(r);
 
         // ------------------------------------------------------------
         // NEW: keep UI responsive + tick spinner once per second
@@ -1518,6 +2508,7 @@ static void ShowFolder(std::wstring abs)
     g_rows.insert(g_rows.end(), files.begin(), files.end());
 
     SortRows(g_sortCol, g_sortAsc);
+    if (net) NetCache_Store(g_folder, g_rows, g_folderStamp);
 
     SendMessageW(g_hwndList, WM_SETREDRAW, TRUE, 0);
     InvalidateRect(g_hwndList, NULL, TRUE);
@@ -1529,572 +2520,4443 @@ static void ShowFolder(std::wstring abs)
 
     // End cleanly (spinner removed / ends effectively on SPC)
     SetTitleFolderOrDrives();
+    FolderWatch_Start(g_folder);
 }
 
-// ----------------------------- Search (videos only, as original)
+// ----------------------------- Patching the shown rows
 
-static bool NameContainsAllTerms(const std::wstring& full,
-                                 const std::vector<std::wstring>& termsLower)
+// What the list shows, by path, so it survives rows changing underneath
+struct ListKeep
 {
-    const wchar_t* base = wcsrchr(full.c_str(), L'\\');
-    base = base ? base + 1 : full.c_str();
-    std::wstring bl = ToLower(base);
-    for (size_t i = 0; i < termsLower.size(); ++i)
-        if (bl.find(termsLower[i]) == std::wstring::npos) return false;
-    return true;
-}
+    std::vector<std::wstring> selected;   // lower-case full paths
+    std::wstring focused, top;
+};
 
-static void SearchRecurseFolder(const std::wstring& folder,
-                                const std::vector<std::wstring>& terms,
-                                std::vector<Row>& out)
+static ListKeep LV_Remember()
 {
-    SetTitleSearchingFolder(folder);
+    ListKeep k;
+    int i = -1;
+    while ((i = ListView_GetNextItem(g_hwndList, i, LVNI_SELECTED)) != -1)
+        if (const Row* r = RowAt(i)) k.selected.push_back(ToLower(r->full));
+    if (const Row* r = RowAt(ListView_GetNextItem(g_hwndList, -1, LVNI_FOCUSED))) k.focused = ToLower(r->full);
+    if (const Row* r = RowAt(ListView_GetTopIndex(g_hwndList))) k.top = ToLower(r->full);
+    return k;
+}
 
-    std::wstring pat = EnsureSlash(folder) + L"*";
-    WIN32_FIND_DATAW fd;
-    ZeroMemory(&fd, sizeof(fd));
-    HANDLE h = FindFirstFileExW(pat.c_str(), FindExInfoBasic, &fd,
-                                FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
-    if (h == INVALID_HANDLE_VALUE) return;
+// Rebuild g_visible after g_rows changed and put selection, focus and the
+// top row back where they were
+static void LV_Restore(const ListKeep& k)
+{
+    RebuildVisible(false);
+    ListView_SetItemState(g_hwndList, -1, 0, LVIS_SELECTED | LVIS_FOCUSED);
+    ListView_SetItemCountEx(g_hwndList, (int)g_visible.size(), LVSICF_NOSCROLL);
 
-    do
+    std::unordered_map<std::wstring, int> item;
+    for (int i = 0; i < (int)g_visible.size(); ++i)
+        item[ToLower(g_rows[g_visible[i]].full)] = i;
+    for (const auto& s : k.selected)
     {
-        if (wcscmp(fd.cFileName, L".") == 0 || wcscmp(fd.cFileName, L"..") == 0) continue;
+        auto it = item.find(s);
+        if (it != item.end()) ListView_SetItemState(g_hwndList, it->second, LVIS_SELECTED, LVIS_SELECTED);
+    }
+    auto f = item.find(k.focused);
+    if (f != item.end()) ListView_SetItemState(g_hwndList, f->second, LVIS_FOCUSED, LVIS_FOCUSED);
 
-        bool isDir = (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
-        std::wstring full = EnsureSlash(folder) + fd.cFileName;
+    auto t = item.find(k.top);
+    RECT rc{};
+    if (t != item.end() && ListView_GetItemRect(g_hwndList, 0, &rc, LVIR_BOUNDS))
+    {
+        int delta = t->second - ListView_GetTopIndex(g_hwndList);
+        if (delta) ListView_Scroll(g_hwndList, 0, delta * (rc.bottom - rc.top));
+    }
+    InvalidateRect(g_hwndList, NULL, TRUE);
+}
 
-        if (isDir)
+// Patch the folder view after our own rename (to) or delete (to empty) of a
+// path; search results have SearchResults_Apply
+static void Rows_PathChanged(const std::wstring& from, const std::wstring& to)
+{
+    if (g_view != ViewKind::Folder) return;
+    const bool keep = !to.empty() && _wcsicmp(ParentDir(to).c_str(), EnsureSlash(g_folder).c_str()) == 0;
+    const ListKeep k = LV_Remember();
+    bool changed = false;
+    for (size_t i = g_rows.size(); i-- > 0; )
+    {
+        Row& r = g_rows[i];
+        const bool isFrom = _wcsicmp(r.full.c_str(), from.c_str()) == 0;
+        const bool isTo = keep && _wcsicmp(r.full.c_str(), to.c_str()) == 0; // replaced
+        if (!isFrom && !isTo) continue;
+        changed = true;
+        if (!isFrom || !keep)
         {
-            if (fd.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) continue;
-            SearchRecurseFolder(full, terms, out);
-        }
-        else if (IsVideoFile(full))
-        {
-            if (NameContainsAllTerms(full, terms))
-            {
-                Row r;
-                r.name = full;
-                r.full = full;
-                r.isDir = false;
-                r.modified = fd.ftLastWriteTime;
-                ULARGE_INTEGER uli;
-                uli.HighPart = fd.nFileSizeHigh;
-                uli.LowPart = fd.nFileSizeLow;
-                r.size = uli.QuadPart;
-
-                GetVideoPropsFastCached(r.full, r.vW, r.vH, r.vDur100ns);
-                out.push_back(r);
-            }
+            g_rows.erase(g_rows.begin() + i);
+            continue;
         }
+        r.full = to;
+        r.name = PathFindFileNameW(to.c_str());
+        r.nameLower.clear();
     }
-    while (FindNextFileW(h, &fd));
-
-    FindClose(h);
+    if (!changed) return;
+    LV_Restore(k);
+    if (!g_inPlayback) SetTitleFolderOrDrives();
 }
 
-static void RunSearchFromOrigin(std::vector<Row>& outResults)
+// WM_APP_FSCHANGE: patch g_rows with the entries the watch thread re-read
+static void FolderWatch_Apply(const FsChangeBatch& b)
 {
-    outResults.clear();
+    if (b.overflow)
+    {
+        LogLine(L"FolderWatch: too many changes in \"%s\", reading it again", g_folder.c_str());
+        ShowFolder(g_folder);
+        return;
+    }
 
-    if (g_search.useExplicitScope)
+    std::unordered_map<std::wstring, size_t> index;   // lower-case full path -> row
+    for (size_t i = 0; i < g_rows.size(); ++i) index[ToLower(g_rows[i].full)] = i;
+
+    const ListKeep k = LV_Remember();
+    std::vector<size_t> gone;
+    std::vector<std::wstring> probe;   // changed videos: the meta worker fills their props
+    size_t added = 0, updated = 0;
+    for (const auto& full : b.gone)
     {
-        for (const auto& file : g_search.explicitFiles)
+        auto it = index.find(ToLower(full));
+        if (it != index.end()) gone.push_back(it->second);
+    }
+    for (const Row& r : b.rows)
+    {
+        auto it = index.find(ToLower(r.full));
+        if (it == index.end())
         {
-            if (!IsVideoFile(file)) continue;
-            if (!NameContainsAllTerms(file, g_search.termsLower)) continue;
+            g_rows.push_back(r);
+            index[ToLower(r.full)] = g_rows.size() - 1;
+            ++added;
+        }
+        else
+        {
+            Row& old = g_rows[it->second];
+            if (old.isDir == r.isDir && old.size == r.size && old.name == r.name &&
+                    CompareFileTime(&old.modified, &r.modified) == 0)
+                continue;
+            old = r;
+            ++updated;
+        }
+        if (!r.isDir && IsVideoFile(r.full)) probe.push_back(r.full);
+    }
+    if (!added && !updated && gone.empty()) return;
 
-            WIN32_FILE_ATTRIBUTE_DATA fad{};
-            if (GetFileAttributesExW(file.c_str(), GetFileExInfoStandard, &fad) &&
-                    (fad.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
-            {
+    std::sort(gone.begin(), gone.end());
+    gone.erase(std::unique(gone.begin(), gone.end()), gone.end());
+    for (size_t n = gone.size(); n-- > 0; ) g_rows.erase(g_rows.begin() + gone[n]);
 
-                Row r;
-                r.name = file;
-                r.full = file;
-                r.isDir = false;
-                r.modified = fad.ftLastWriteTime;
+    SortRows(g_sortCol, g_sortAsc, false);
+    LV_Restore(k);
+    QueueMetaPaths(probe);
+    if (!g_inPlayback) SetTitleFolderOrDrives();
+    LogLine(L"FolderWatch: \"%s\" +%zu -%zu ~%zu", g_folder.c_str(), added, gone.size(), updated);
+}
 
-                ULARGE_INTEGER uli{};
-                uli.HighPart = fad.nFileSizeHigh;
-                uli.LowPart = fad.nFileSizeLow;
-                r.size = uli.QuadPart;
+// ----------------------------- Drive probes
 
-                GetVideoPropsFastCached(r.full, r.vW, r.vH, r.vDur100ns);
-                outResults.push_back(std::move(r));
-            }
-        }
+// The Drives view lists the letters at once; each drive's type and mapping,
+// and the WNet connection list, are looked up on their own threads so one
+// dead network drive cannot hold the view. A drive that has not answered by
+// the deadline is shown red until it does.
 
-        for (const auto& folder : g_search.explicitFolders)
-        {
-            SetTitleSearchingFolder(folder);
-            SearchRecurseFolder(folder, g_search.termsLower, outResults);
-        }
-        return;
-    }
+constexpr UINT WM_APP_DRIVEPROBE = WM_APP + 104;   // lParam: DriveProbe*
+constexpr UINT kDriveProbeTimeoutMs = 3000;
+constexpr int kDriveProbeMaxThreads = 64;          // stuck probes included
 
-    if (g_search.originView == ViewKind::Drives)
+struct DriveProbe
+{
+    unsigned gen = 0;
+    int drive = -1;                  // 0..25, or -1: the connected mappings
+    DWORD startTick = 0;
+    UINT type = DRIVE_UNKNOWN;
+    bool hasPersistent = false;
+    std::wstring persistentRemote;
+    DWORD connectedMask = 0;
+    std::wstring remoteByLetter[26];
+};
+
+struct DriveState
+{
+    bool probing = false, answered = false, timedOut = false;
+    UINT type = DRIVE_UNKNOWN;
+    bool hasPersistent = false;
+    std::wstring persistentRemote;
+};
+
+static struct
+{
+    unsigned gen = 0;
+    DriveState drive[26];
+    bool netAnswered = false;
+    DWORD connectedMask = 0;
+    std::wstring remoteByLetter[26];
+} g_drv;
+
+static std::atomic<int> g_driveProbesRunning{ 0 };
+
+static DWORD WINAPI DriveProbeProc(LPVOID param)
+{
+    DriveProbe* p = (DriveProbe*)param;
+    if (p->drive < 0)
     {
-        DWORD mask = GetLogicalDrives();
-        for (int i = 0; i < 26; ++i)
-        {
-            if (!(mask & (1u << i))) continue;
-            wchar_t root[4] = { wchar_t(L'A' + i), L':', L'\\', 0 };
-            SetTitleSearchingFolder(root);
-            SearchRecurseFolder(root, g_search.termsLower, outResults);
-        }
+        // Currently-connected mapped drives (like "net use" Status=OK)
+        p->connectedMask = GetConnectedNetDriveMaskAndRemotes(p->remoteByLetter);
     }
     else
     {
-        SetTitleSearchingFolder(g_search.originFolder);
-        SearchRecurseFolder(g_search.originFolder, g_search.termsLower, outResults);
+        const wchar_t letter = (wchar_t)(L'A' + p->drive);
+        const wchar_t root[4] = { letter, L':', L'\\', 0 };
+        p->type = GetDriveTypeW(root);
+        // Persistent mapping (exists even if disconnected)
+        p->hasPersistent = GetPersistentMappedRemotePath(letter, p->persistentRemote);
     }
+    --g_driveProbesRunning;
+    if (!PostMessageW(g_hwndMain, WM_APP_DRIVEPROBE, 0, (LPARAM)p)) delete p;
+    return 0;
 }
 
-static void ShowSearchResults(const std::vector<Row>& results)
+static bool Drives_Spawn(int drive)
 {
-    CancelMetaWorkAndClearTodo();
-
-    g_view = ViewKind::Search;
-    g_rows = results;
+    if (g_driveProbesRunning.load() >= kDriveProbeMaxThreads) return false;
+    DriveProbe* p = new DriveProbe;
+    p->gen = g_drv.gen;
+    p->drive = drive;
+    p->startTick = GetTickCount();
+    ++g_driveProbesRunning;
+    HANDLE h = CreateThread(NULL, 0, DriveProbeProc, p, 0, NULL);
+    if (h)
+    {
+        CloseHandle(h);
+        return true;
+    }
+    --g_driveProbesRunning;
+    delete p;
+    return false;
+}
 
-    SendMessageW(g_hwndList, WM_SETREDRAW, FALSE, 0);
-    LV_ResetColumns();
-    SortRows(g_sortCol, g_sortAsc);
-    SendMessageW(g_hwndList, WM_SETREDRAW, TRUE, 0);
-    InvalidateRect(g_hwndList, NULL, TRUE);
+// Probe every drive in mask (and the connection list) in parallel
+static void Drives_StartProbes(DWORD mask)
+{
+    ++g_drv.gen;
+    for (DriveState& d : g_drv.drive) d = DriveState{};
+    g_drv.netAnswered = false;
+    g_drv.connectedMask = 0;
+    for (auto& s : g_drv.remoteByLetter) s.clear();
 
-    std::wstring t = L"Browse - Search - " + JoinTermsForTitle();
-    wchar_t buf[64];
-    swprintf_s(buf, L" - %zu file(s)", g_rows.size());
-    t += buf;
-    SetWindowTextW(g_hwndMain, t.c_str());
+    for (int i = 0; i < 26; ++i)
+        if (mask & (1u << i)) g_drv.drive[i].probing = true;
+    for (int i = 0; i < 26; ++i)
+        if (g_drv.drive[i].probing && !Drives_Spawn(i))
+            LogLine(L"Drives: no probe thread for %c:", (wchar_t)(L'A' + i));
+    if (!Drives_Spawn(-1)) LogLine(L"Drives: no probe thread for the connected mappings");
 
-    QueueMissingPropsAndKickWorker();
+    SetTimer(g_hwndMain, kTimerDriveProbe, kDriveProbeTimeoutMs, NULL);
 }
 
-static void ExitSearchToOrigin()
+// Bring the drive rows in line with what the probes have said so far
+static void Drives_Refresh()
 {
-    if (!g_search.active) return;
-    if (g_search.originView == ViewKind::Drives) ShowDrives();
-    else ShowFolder(g_search.originFolder);
-    g_search = SearchState();
-}
-
-// ----------------------------- File operations
+    if (g_view != ViewKind::Drives) return;
 
-static std::wstring UniqueName(const std::wstring& folder,
-                               const std::wstring& base,
-                               const std::wstring& ext)
-{
-    std::wstring f = EnsureSlash(folder);
-    std::wstring target = f + base + ext;
-    if (!PathFileExistsW(target.c_str())) return target;
-    for (int i = 1; i < 10000; ++i)
+    const ListKeep k = LV_Remember();
+    for (size_t n = g_rows.size(); n-- > 0; )
     {
-        wchar_t buf[32];
-        swprintf_s(buf, L" (%d)", i);
-        std::wstring t = f + base + buf + ext;
-        if (!PathFileExistsW(t.c_str())) return t;
+        Row& r = g_rows[n];
+        const int i = r.full.empty() ? -1 : (int)towupper(r.full[0]) - L'A';
+        if (i < 0 || i >= 26) continue;
+        const DriveState& d = g_drv.drive[i];
+
+        // Hide optical drives (CD/DVD/BD)
+        if (d.answered && d.type == DRIVE_CDROM)
+        {
+            g_rows.erase(g_rows.begin() + n);
+            continue;
+        }
+
+        const bool connected = g_drv.netAnswered && (g_drv.connectedMask & (1u << i)) != 0;
+        r.netRemote = connected ? g_drv.remoteByLetter[i] : std::wstring();
+        if (r.netRemote.empty() && d.hasPersistent) r.netRemote = d.persistentRemote;
+
+        // Broken mapped drive (red + block activate): persistent but not
+        // connected, or no answer in time
+        r.isBrokenNetDrive = d.answered ? (d.hasPersistent && g_drv.netAnswered && !connected)
+                                        : d.timedOut;
+        r.name = r.full;
+        if (r.isBrokenNetDrive) r.name.resize(2);   // "X:" (no trailing slash)
     }
-    return target;
+    LV_Restore(k);
+    if (!g_inPlayback) SetTitleFolderOrDrives();
 }
 
-// Clipboard: now includes files AND directories
-static void Browser_CopySelectedToClipboard(ClipMode mode)
+// WM_APP_DRIVEPROBE: one probe answered (late answers still count)
+static void Drives_OnProbe(const DriveProbe& p)
 {
-    g_clipFiles.clear();
-    g_clipMode = ClipMode::None;
-    if (g_view == ViewKind::Drives) return;
+    if (p.drive >= 0) g_driveTypeSeen[p.drive] = p.type;
+    if (p.gen != g_drv.gen) return;
 
-    std::vector<int> selectedIdx;
-    int idx = -1;
-    while ((idx = ListView_GetNextItem(g_hwndList, idx, LVNI_SELECTED)) != -1)
+    const DWORD ms = GetTickCount() - p.startTick;
+    if (p.drive < 0)
     {
-        if (idx < 0 || idx >= (int)g_rows.size()) continue;
-        const Row& r = g_rows[idx];
-        g_clipFiles.push_back(r.full);
-        selectedIdx.push_back(idx);
+        g_drv.netAnswered = true;
+        g_drv.connectedMask = p.connectedMask;
+        for (int i = 0; i < 26; ++i) g_drv.remoteByLetter[i] = p.remoteByLetter[i];
+        if (ms >= kDriveProbeTimeoutMs) LogLine(L"Drives: connected mappings answered after %lu ms", ms);
     }
-    if (g_clipFiles.empty()) return;
-
-    g_clipMode = mode;
-
-    if (mode == ClipMode::Move)
+    else
     {
-        SendMessageW(g_hwndList, WM_SETREDRAW, FALSE, 0);
-        std::sort(selectedIdx.begin(), selectedIdx.end());
-        for (int n = (int)selectedIdx.size() - 1; n >= 0; --n)
-        {
-            int rIdx = selectedIdx[n];
-            if (rIdx >= 0 && rIdx < (int)g_rows.size())
-            {
-                g_rows.erase(g_rows.begin() + rIdx);
-                ListView_DeleteItem(g_hwndList, rIdx);
-            }
-        }
-        SendMessageW(g_hwndList, WM_SETREDRAW, TRUE, 0);
-        InvalidateRect(g_hwndList, NULL, TRUE);
+        DriveState& d = g_drv.drive[p.drive];
+        d.answered = true;
+        d.type = p.type;
+        d.hasPersistent = p.hasPersistent;
+        d.persistentRemote = p.persistentRemote;
+        if (ms >= kDriveProbeTimeoutMs || d.timedOut)
+            LogLine(L"Drives: %c: answered after %lu ms", (wchar_t)(L'A' + p.drive), ms);
     }
-    // NEW: also publish to the system clipboard as CF_HDROP so that
-    // Explorer / Remote Desktop etc. can see the file list.
-    SetClipboardFileDrop(g_clipFiles, mode);
-
+    Drives_Refresh();
 }
 
-// ----------------------------- DPI helpers
-
-typedef UINT(WINAPI* GetDpiForWindow_t)(HWND);
-static int DpiScale(int px)
+// kTimerDriveProbe: drives still silent are shown as broken
+static void Drives_OnProbeTimeout()
 {
-    UINT dpi = 96;
-    HMODULE m = GetModuleHandleW(L"user32.dll");
-    if (m)
+    KillTimer(g_hwndMain, kTimerDriveProbe);
+
+    bool any = false;
+    for (int i = 0; i < 26; ++i)
     {
-        GetDpiForWindow_t p = (GetDpiForWindow_t)GetProcAddress(m, "GetDpiForWindow");
-        if (p) dpi = p(g_hwndMain ? g_hwndMain : GetDesktopWindow());
+        DriveState& d = g_drv.drive[i];
+        if (!d.probing || d.answered) continue;
+        d.timedOut = any = true;
+        LogLine(L"Drives: %c: no answer in %u ms", (wchar_t)(L'A' + i), kDriveProbeTimeoutMs);
     }
-    return MulDiv(px, dpi, 96);
+    if (!g_drv.netAnswered)
+        LogLine(L"Drives: connected mappings: no answer in %u ms", kDriveProbeTimeoutMs);
+    if (any) Drives_Refresh();
 }
 
-// ---------- Operation (copy/move) sub-modal window + cancellable copy support
+// ----------------------------- Navigation cache
+//
+// The last folders we left, kept as they were shown: rows, sort order,
+// selection and top row. Going back to one (Left, Right, Enter, leaving a
+// search) shows it at once and lists it again on a low-priority thread;
+// the differences are then patched in like live changes. The folder's
+// last-write time is not trusted for this: it does not move when a file in
+// the folder grows. Least recently used listings go first once there are
+// kNavCacheMaxEntries of them or they take kNavCacheMaxBytes.
+//
+// When the focus rests on a folder row for kPrefetchDwellMs, that folder is
+// listed into the cache ahead of time, so Enter shows it at once. Moving the
+// focus cancels the listing; one that runs past kPrefetchMaxEntries is
+// abandoned.
+
+constexpr UINT WM_APP_NAVLIST = WM_APP + 103;   // lParam: NavListing*
+static const size_t kNavCacheMaxEntries = 32;
+static const size_t kNavCacheMaxBytes = 64 * 1024 * 1024;
+static const size_t kNavForwardMax = 64;
+static const ULONGLONG kNavFreshMs = 2000;    // listed this recently: no revalidation
+// Listed in full this recently (and within the share's TTL): an unchanged
+// folder last-write time is taken as proof that nothing changed. Files that
+// grow in place do not move it, so older listings are read again in full.
+static const ULONGLONG kNavStampTrustMs = 60000;
+static const UINT kPrefetchDwellMs = 400;
+static const size_t kPrefetchMaxEntries = 50000;
+
+struct NavEntry
+{
+    std::wstring folder;       // with trailing slash
+    std::vector<Row> rows;
+    int sortCol = 0;
+    bool sortAsc = true;
+    ListKeep keep;
+    size_t bytes = 0;
+    ULONGLONG listedTick = 0;
+    bool prefetched = false;   // not opened yet
+    FILETIME stamp{};          // g_folderStamp when listed
+    ULONGLONG fullTick = 0;    // g_folderListedTick when listed
+};
 
-struct OpUI
+static std::list<NavEntry> g_navCache;        // most recently used first
+static size_t g_navCacheBytes = 0;
+static size_t g_navLookups = 0, g_navHits = 0;
+static unsigned g_navListGen = 0;             // newest background listing
+static bool g_navListRunning = false;         // one revalidation thread at a time
+static bool g_navListAgain = false;           // revalidate the shown folder when it ends
+static std::atomic<bool> g_navListCancel{ false }; // the view moved on: stop waiting for a slot
+static std::vector<std::wstring> g_navForward; // folders Left came up from, for Right
+
+static std::atomic<unsigned> g_prefetchGen{ 0 }; // bumped on every focus change
+static std::atomic<bool> g_prefetchCancel{ false }; // the focus moved: stop waiting for a slot
+static std::atomic<bool> g_prefetchRunning{ false }; // one prefetch thread at a time
+struct PrefetchStats
 {
-    HWND hwnd{}, hText{}, hCancel{};
-    std::atomic<bool> cancel{ false };
-    BOOL* pCancelFlag{ nullptr };
-} g_op;
+    size_t started = 0, cached = 0, used = 0;
+    size_t listed = 0, usedEntries = 0;   // directory entries read / shown from a prefetch
+} g_prefetchStats;
 
-static LRESULT CALLBACK OpProc(HWND h, UINT m, WPARAM w, LPARAM l)
+// A folder listed on a worker thread (rows without video props)
+struct NavListing
 {
-    switch (m)
-    {
-    case WM_CREATE:
-    {
-        HFONT hf = (HFONT)GetStockObject(DEFAULT_GUI_FONT);
-        RECT rc{};
-        GetClientRect(h, &rc);
-        int margin = DpiScale(12);
-        int btnW = DpiScale(100), btnH = DpiScale(28);
-
-        g_op.hText = CreateWindowExW(
-                         WS_EX_TRANSPARENT, L"STATIC", L"",
-                         WS_CHILD | WS_VISIBLE | SS_LEFT,
-                         margin, margin, rc.right - 2 * margin, DpiScale(32),
-                         h, (HMENU)101, g_hInst, NULL);
-        SendMessageW(g_op.hText, WM_SETFONT, (WPARAM)hf, TRUE);
-
-        g_op.hCancel = CreateWindowExW(
-                           0, L"BUTTON", L"Cancel",
-                           WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON,
-                           rc.right - margin - btnW, rc.bottom - margin - btnH,
-                           btnW, btnH, h, (HMENU)IDCANCEL, g_hInst, NULL);
-        SendMessageW(g_op.hCancel, WM_SETFONT, (WPARAM)hf, TRUE);
-        return 0;
-    }
-    case WM_SIZE:
-    {
-        RECT rc{};
-        GetClientRect(h, &rc);
-        int margin = DpiScale(12);
-        int btnW = DpiScale(100), btnH = DpiScale(28);
-        if (g_op.hText)
-            MoveWindow(g_op.hText, margin, margin,
-                       rc.right - 2 * margin, DpiScale(32), TRUE);
-        if (g_op.hCancel)
-            MoveWindow(g_op.hCancel,
-                       rc.right - margin - btnW,
-                       rc.bottom - margin - btnH,
-                       btnW, btnH, TRUE);
-        return 0;
-    }
-    case WM_COMMAND:
-        if (LOWORD(w) == IDCANCEL)
-        {
-            if (g_op.pCancelFlag) *g_op.pCancelFlag = TRUE;
-            g_op.cancel.store(true, std::memory_order_relaxed);
-            DestroyWindow(h);
-            return 0;
-        }
-        break;
-    case WM_CLOSE:
-        if (g_op.pCancelFlag) *g_op.pCancelFlag = TRUE;
-        g_op.cancel.store(true, std::memory_order_relaxed);
-        DestroyWindow(h);
-        return 0;
-    case WM_DESTROY:
-        g_op.hwnd = NULL;
-        return 0;
-    }
-    return DefWindowProcW(h, m, w, l);
+    std::wstring folder;
+    std::vector<Row> rows;
+    unsigned gen = 0;          // g_navListGen, or g_prefetchGen for a prefetch
+    bool prefetch = false;
+    bool ok = false;
+    FILETIME stamp{};          // the folder's last-write time
+    bool checkStamp = false;   // stamp unchanged: do not list it again
+    bool unchanged = false;
+    DWORD error = 0;           // !ok: why the folder could not be listed
+};
+
+static size_t RowsBytes(const std::vector<Row>& rows)
+{
+    size_t n = rows.capacity() * sizeof(Row);
+    for (const auto& r : rows)
+        n += (r.name.capacity() + r.full.capacity() + r.nameLower.capacity() +
+              r.netRemote.capacity()) * sizeof(wchar_t);
+    return n;
 }
 
-static void EnsureOpWndClass()
+static void NavCache_Log(const wchar_t* what, const std::wstring& folder)
 {
-    static bool reg = false;
-    if (!reg)
-    {
-        WNDCLASSW wc{};
-        wc.lpfnWndProc = OpProc;
-        wc.hInstance = g_hInst;
-        wc.hCursor = LoadCursor(NULL, IDC_ARROW);
-        wc.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
-        wc.lpszClassName = L"OpProgressClass";
-        RegisterClassW(&wc);
-        reg = true;
-    }
+    LogLine(L"NavCache: %s \"%s\" (%zu of %zu lookups hit, %zu listings, %s)",
+            what, folder.c_str(), g_navHits, g_navLookups, g_navCache.size(),
+            FormatSize(g_navCacheBytes).c_str());
 }
 
-static HWND CreateOpWindow(const wchar_t* title)
+static std::list<NavEntry>::iterator NavCache_Find(const std::wstring& folder)
 {
-    EnsureOpWndClass();
+    auto it = g_navCache.begin();
+    while (it != g_navCache.end() && _wcsicmp(it->folder.c_str(), folder.c_str()) != 0) ++it;
+    return it;
+}
 
-    MONITORINFO mi{ sizeof(mi) };
-    HMONITOR hm = MonitorFromWindow(g_hwndMain, MONITOR_DEFAULTTONEAREST);
-    GetMonitorInfoW(hm, &mi);
-    RECT wa = mi.rcWork;
+// Add (or replace) a listing as the most recently used one
+static void NavCache_Put(NavEntry e)
+{
+    auto it = NavCache_Find(e.folder);
+    if (it != g_navCache.end())
+    {
+        g_navCacheBytes -= it->bytes;
+        g_navCache.erase(it);
+    }
 
-    int W = DpiScale(560), H = DpiScale(110);
-    int X = wa.left + ((wa.right - wa.left) - W) / 2;
-    int Y = wa.top + ((wa.bottom - wa.top) - H) / 2;
+    e.bytes = RowsBytes(e.rows) + sizeof(NavEntry);
+    g_navCacheBytes += e.bytes;
+    g_navCache.push_front(std::move(e));
 
-    HWND h = CreateWindowExW(
-                 WS_EX_DLGMODALFRAME | WS_EX_TOPMOST,
-                 L"OpProgressClass", title,
-                 WS_POPUPWINDOW | WS_CAPTION | WS_SYSMENU | WS_VISIBLE,
-                 X, Y, W, H, g_hwndMain, NULL, g_hInst, NULL);
-    g_op.hwnd = h;
-    return h;
+    while (g_navCache.size() > 1 &&
+            (g_navCache.size() > kNavCacheMaxEntries || g_navCacheBytes > kNavCacheMaxBytes))
+    {
+        g_navCacheBytes -= g_navCache.back().bytes;
+        g_navCache.pop_back();
+    }
+}
+
+// The view moves elsewhere: a revalidation still running is of no use
+static void NavCache_StopRevalidate()
+{
+    ++g_navListGen;
+    g_navListCancel = true;
+    g_navListAgain = false;
 }
 
-static DWORD CALLBACK CopyProgressThunk(LARGE_INTEGER, LARGE_INTEGER,
-                                        LARGE_INTEGER, LARGE_INTEGER,
-                                        DWORD, DWORD, HANDLE, HANDLE, LPVOID lpData)
+// Keep the folder on screen before the view moves elsewhere
+static void NavCache_Save()
 {
-    OpUI* op = reinterpret_cast<OpUI*>(lpData);
-    PumpMessagesThrottled(10);
-    if (op && op->cancel.load(std::memory_order_relaxed))
+    NavCache_StopRevalidate();
+    if (g_folderGone)
     {
-        return PROGRESS_CANCEL;
+        g_folderGone = false;
+        return;
     }
-    return PROGRESS_CONTINUE;
+    if (g_view != ViewKind::Folder || g_folder.empty() || g_loadingFolder) return;
+
+    NavEntry e;
+    e.folder = EnsureSlash(g_folder);
+    e.rows = g_rows;
+    e.sortCol = g_sortCol;
+    e.sortAsc = g_sortAsc;
+    e.keep = LV_Remember();
+    e.listedTick = GetTickCount64(); // the folder was watched until now
+    e.stamp = g_folderStamp;
+    e.fullTick = g_folderListedTick;
+    if (IsNetworkFolder(e.folder)) NetCache_Store(e.folder, e.rows, e.stamp);
+    NavCache_Put(std::move(e));
 }
 
-static bool SameVolume(const std::wstring& a, const std::wstring& b)
+static void NavListProc_List(NavListing* l);
+
+static DWORD WINAPI NavListProc(LPVOID p)
 {
-    wchar_t va[MAX_PATH] {}, vb[MAX_PATH] {};
-    if (!GetVolumePathNameW(a.c_str(), va, MAX_PATH)) return false;
-    if (!GetVolumePathNameW(b.c_str(), vb, MAX_PATH)) return false;
-    return _wcsicmp(va, vb) == 0;
-}
+    NavListing* l = (NavListing*)p;
+    SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
 
-// Recursive directory helpers
+    // A prefetch or revalidation is background I/O like any other: it waits
+    // for a slot on the folder's device and pays into the playback budget
+    const std::atomic<bool>* cancel = l->prefetch ? &g_prefetchCancel : &g_navListCancel;
+    IoGovernor_Throttle(kMetaProbeBytes, cancel);
+    {
+        IoSlot slot(IoDeviceForPath(l->folder), nullptr, cancel);
+        if (slot.ok && !cancel->load()) NavListProc_List(l);
+    }
+    if (l->prefetch) g_prefetchRunning = false;
+    SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_END);
+    if (!PostMessageW(g_hwndMain, WM_APP_NAVLIST, 0, (LPARAM)l)) delete l;
+    return 0;
+}
 
-// Recursive delete of a directory tree.
-// - Normal directories: recurse and delete contents, then remove the dir.
-// - Reparse-point dirs (junctions/symlink dirs): do NOT recurse into target,
-//   just remove the link itself (RemoveDirectoryW).
-static bool DeleteDirectoryTree(const std::wstring& path)
+static void NavListProc_List(NavListing* l)
 {
-    // Normalize: ensure trailing slash for enumeration
-    std::wstring dir = EnsureSlash(path);
 
-    // Enumerate children
-    WIN32_FIND_DATAW fd{};
-    HANDLE h = FindFirstFileW((dir + L"*").c_str(), &fd);
+    // Nothing was added, removed or renamed since: one round trip instead of a listing
+    WIN32_FILE_ATTRIBUTE_DATA dirAttrs{};
+    if (GetFileAttributesExW(l->folder.c_str(), GetFileExInfoStandard, &dirAttrs))
+    {
+        l->unchanged = l->checkStamp && CompareFileTime(&dirAttrs.ftLastWriteTime, &l->stamp) == 0;
+        l->stamp = dirAttrs.ftLastWriteTime;
+    }
+
+    WIN32_FIND_DATAW fd;
+    HANDLE h = l->unchanged ? INVALID_HANDLE_VALUE :
+               FindFirstFileExW((l->folder + L"*").c_str(), FindExInfoBasic, &fd,
+                                FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+    l->ok = l->unchanged;
     if (h != INVALID_HANDLE_VALUE)
     {
+        l->ok = true;
         do
         {
-            if (wcscmp(fd.cFileName, L".") == 0 ||
-                    wcscmp(fd.cFileName, L"..") == 0)
-                continue;
-
-            std::wstring child = dir + fd.cFileName;
-            bool isDir = (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
-            bool isReparse = (fd.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0;
-
-            if (isDir)
-            {
-                if (isReparse)
-                {
-                    // Junction / symlink folder: remove the link itself, don't recurse
-                    ClearReadonlyAndSystem(child);
-                    if (!RemoveDirectoryW(child.c_str()))
-                    {
-                        MoveFileExW(child.c_str(), NULL, MOVEFILE_DELAY_UNTIL_REBOOT);
-                    }
-                }
-                else
-                {
-                    // Normal directory: recurse into it
-                    DeleteDirectoryTree(child);
-                }
-            }
-            else
+            // A prefetch stops as soon as the focus moves on, or when it gets too big
+            if (l->prefetch && (g_prefetchGen.load(std::memory_order_relaxed) != l->gen ||
+                                l->rows.size() >= kPrefetchMaxEntries))
             {
-                // Normal file or reparse file (symlink to file)
-                ClearReadonlyAndSystem(child);
-                if (!DeleteFileW(child.c_str()))
-                {
-                    MoveFileExW(child.c_str(), NULL, MOVEFILE_DELAY_UNTIL_REBOOT);
-                }
+                l->ok = false;
+                break;
             }
+            if (wcscmp(fd.cFileName, L".") == 0 || wcscmp(fd.cFileName, L"..") == 0) continue;
+            if (_wcsicmp(fd.cFileName, kTrashDirName) == 0) continue;
+            l->rows.push_back(MakeFolderRow(l->folder, fd, false));
         }
         while (FindNextFileW(h, &fd));
         FindClose(h);
     }
-
-    // Finally delete this directory itself
-    // (clear read-only/system attr first so RemoveDirectoryW succeeds)
-    std::wstring dirNoSlash = path;
-    // Strip trailing slash for safety (RemoveDirectory is happier with "C:\foo" than "C:\foo\")
-    while (!dirNoSlash.empty() &&
-            (dirNoSlash.back() == L'\\' || dirNoSlash.back() == L'/') &&
-            !IsDriveRoot(dirNoSlash))
+    else if (!l->unchanged)
     {
-        dirNoSlash.pop_back();
+        l->error = GetLastError();
+        l->ok = (l->error == ERROR_FILE_NOT_FOUND); // an empty drive root
     }
+}
 
-    ClearReadonlyAndSystem(dirNoSlash);
-
-    if (!RemoveDirectoryW(dirNoSlash.c_str()))
+// List the shown folder again in the background (NavCache_OnListing patches it).
+// While an earlier one still runs (maybe stuck on a dead share) it is
+// cancelled, and this one starts when it ends.
+static void NavCache_Revalidate()
+{
+    const unsigned gen = ++g_navListGen;
+    if (g_navListRunning)
+    {
+        g_navListCancel = true;
+        g_navListAgain = true;
+        return;
+    }
+
+    NavListing* l = new NavListing;
+    l->folder = g_folder;
+    l->gen = gen;
+    l->stamp = g_folderStamp;
+    const int ttl = NetCache_Ttl(g_folder);
+    const ULONGLONG trustMs = ttl < 0 ? kNavStampTrustMs
+                                     : std::min(kNavStampTrustMs, (ULONGLONG)ttl * 1000);
+    l->checkStamp = (g_folderStamp.dwLowDateTime | g_folderStamp.dwHighDateTime) != 0 &&
+                    GetTickCount64() - g_folderListedTick < trustMs;
+    g_navListCancel = false;
+    g_navListRunning = true;
+    HANDLE h = CreateThread(NULL, 0, NavListProc, l, 0, NULL);
+    if (h)
+    {
+        CloseHandle(h);
+        return;
+    }
+    g_navListRunning = false;
+    delete l;
+}
+
+
+static void NavCache_Display(NavEntry& e, bool revalidate);
+
+// Show abs from the cache and revalidate it; false if it is not cached
+static bool NavCache_Show(std::wstring abs)
+{
+    if (abs.size() == 2 && abs[1] == L':') abs += L'\\';
+    abs = EnsureSlash(abs);
+    ++g_navLookups;
+
+    auto it = NavCache_Find(abs);
+    if (it == g_navCache.end())
+    {
+        NavCache_Log(L"miss", abs);
+        return false;
+    }
+    NavEntry e = std::move(*it);
+    g_navCacheBytes -= e.bytes;
+    g_navCache.erase(it);
+    ++g_navHits;
+    if (e.prefetched)
+    {
+        ++g_prefetchStats.used;
+        g_prefetchStats.usedEntries += e.rows.size();
+    }
+    NavCache_Display(e, GetTickCount64() - e.listedTick > kNavFreshMs);
+    NavCache_Log(e.prefetched ? L"prefetch hit" : L"hit", abs);
+    return true;
+}
+
+// Show a listing we hold (revalidate: list it again in the background)
+static void NavCache_Display(NavEntry& e, bool revalidate)
+{
+    NavCache_Save();
+    CancelMetaWorkAndClearTodo();
+    QuickFilter_Clear();
+
+    g_view = ViewKind::Folder;
+    g_folder = e.folder;
+    g_folderStamp = e.stamp;
+    g_folderListedTick = e.fullTick;
+    g_rows.swap(e.rows);
+
+    SendMessageW(g_hwndList, WM_SETREDRAW, FALSE, 0);
+    LV_ResetColumns();
+    ListView_DeleteAllItems(g_hwndList);
+    if (e.sortCol != g_sortCol || e.sortAsc != g_sortAsc) SortRows(g_sortCol, g_sortAsc, false);
+    LV_Restore(e.keep);
+    SendMessageW(g_hwndList, WM_SETREDRAW, TRUE, 0);
+    InvalidateRect(g_hwndList, NULL, TRUE);
+
+    QueueMissingPropsAndKickWorker();
+    SetTitleFolderOrDrives();
+    FolderWatch_Start(g_folder);
+    if (revalidate) NavCache_Revalidate();
+}
+
+// A prefetch finished (or gave up): keep it unless the folder is open already
+static void NavCache_OnPrefetched(NavListing& l)
+{
+    PrefetchStats& st = g_prefetchStats;
+    st.listed += l.rows.size();
+    const bool shown = (g_view == ViewKind::Folder && _wcsicmp(l.folder.c_str(), g_folder.c_str()) == 0);
+    if (l.ok && !shown && NavCache_Find(l.folder) == g_navCache.end())
+    {
+        NavEntry e;
+        e.folder = l.folder;
+        e.rows.swap(l.rows);
+        e.sortCol = -1; // sorted when shown
+        e.listedTick = GetTickCount64();
+        e.prefetched = true;
+        e.stamp = l.stamp;
+        e.fullTick = e.listedTick;
+        if (IsNetworkFolder(e.folder)) NetCache_Store(e.folder, e.rows, e.stamp);
+        NavCache_Put(std::move(e));
+        ++st.cached;
+    }
+    LogLine(L"Prefetch: \"%s\" %s; %zu of %zu prefetches used, %zu of %zu entries read were shown",
+            l.folder.c_str(), l.ok ? L"listed" : L"cancelled", st.used, st.started,
+            st.usedEntries, st.listed);
+}
+
+// WM_APP_NAVLIST: patch the shown folder with a fresh listing of it
+static void NavCache_OnListing(NavListing& l)
+{
+    if (l.prefetch)
+    {
+        NavCache_OnPrefetched(l);
+        return;
+    }
+    g_navListRunning = false;
+    if (g_navListAgain)
+    {
+        g_navListAgain = false;
+        if (g_view == ViewKind::Folder && !g_loadingFolder) NavCache_Revalidate();
+        return;
+    }
+    if (l.gen != g_navListGen || g_view != ViewKind::Folder || g_loadingFolder ||
+            _wcsicmp(l.folder.c_str(), g_folder.c_str()) != 0)
+        return;
+    if (!l.ok)
+    {
+        // Deleted, or its share dropped: what the cache showed is not there
+        LogLine(L"NavCache: \"%s\" cannot be listed (error %lu), cached rows dropped",
+                g_folder.c_str(), l.error);
+        auto it = NavCache_Find(g_folder);
+        if (it != g_navCache.end())
+        {
+            g_navCacheBytes -= it->bytes;
+            g_navCache.erase(it);
+        }
+        NetCache_Drop(g_folder);
+        g_folderGone = true;
+        FolderWatch_Stop();
+        g_folderStamp = FILETIME{};
+        g_rows.clear();
+        LV_Rebuild();
+        if (g_inPlayback) return;
+        wchar_t msg[96];
+        swprintf_s(msg, L"  [not available, error %lu]", l.error);
+        SetWindowTextW(g_hwndMain, (L"Browse - " + EnsureSlash(g_folder) + msg).c_str());
+        return;
+    }
+    const bool net = IsNetworkFolder(g_folder);
+    // Only a full listing makes the stored one fresh again: the stamp check
+    // cannot see files that grew in place
+    if (l.unchanged)
+    {
+        LogLine(L"NavCache: \"%s\" unchanged since it was listed", g_folder.c_str());
+        return;
+    }
+    g_folderStamp = net ? l.stamp : FILETIME{};
+    g_folderListedTick = GetTickCount64();
+
+    const ListKeep k = LV_Remember();
+    std::unordered_map<std::wstring, size_t> index;   // lower-case full path -> row
+    for (size_t i = 0; i < g_rows.size(); ++i) index[ToLower(g_rows[i].full)] = i;
+
+    std::vector<Row> next;
+    std::vector<std::wstring> probe;
+    next.reserve(l.rows.size());
+    size_t added = 0, updated = 0;
+    for (Row& r : l.rows)
+    {
+        auto it = index.find(ToLower(r.full));
+        if (it != index.end())
+        {
+            Row& old = g_rows[it->second];
+            if (old.isDir == r.isDir && old.size == r.size && old.name == r.name &&
+                    CompareFileTime(&old.modified, &r.modified) == 0)
+            {
+                next.push_back(std::move(old));
+                continue;
+            }
+            ++updated;
+        }
+        else
+        {
+            ++added;
+        }
+        if (!r.isDir && IsVideoFile(r.full)) probe.push_back(r.full);
+        next.push_back(std::move(r));
+    }
+    const size_t removed = g_rows.size() + added - next.size();
+    LogLine(L"NavCache: \"%s\" revalidated: +%zu -%zu ~%zu", g_folder.c_str(), added, removed, updated);
+    if (!added && !updated && !removed)
+    {
+        if (net) NetCache_Store(g_folder, g_rows, g_folderStamp);
+        return;
+    }
+
+    g_rows.swap(next);
+    SortRows(g_sortCol, g_sortAsc, false);
+    if (net) NetCache_Store(g_folder, g_rows, g_folderStamp);
+    LV_Restore(k);
+    QueueMetaPaths(probe);
+    if (!g_inPlayback) SetTitleFolderOrDrives();
+}
+
+static bool NetCache_Show(std::wstring abs);
+
+// Open a folder, from the navigation cache or the stored network listing
+// when we have it
+static void OpenFolder(const std::wstring& abs)
+{
+    if (NavCache_Show(abs) || NetCache_Show(abs)) return;
+    ++g_prefetchGen; // a prefetch of it still running would read it twice
+    ShowFolder(abs);
+}
+
+// The focused row changed: restart the dwell and cancel a running prefetch
+static void Prefetch_OnFocusChanged(HWND h)
+{
+    ++g_prefetchGen;
+    g_prefetchCancel = true;
+    KillTimer(h, kTimerPrefetch);
+    if (g_view != ViewKind::Search && !g_loadingFolder && !g_inPlayback)
+        SetTimer(h, kTimerPrefetch, kPrefetchDwellMs, NULL);
+}
+
+// kTimerPrefetch: the focus stayed on one row
+static void Prefetch_Start()
+{
+    if (g_view == ViewKind::Search || g_loadingFolder || g_inPlayback) return;
+    const Row* r = RowAt(ListView_GetNextItem(g_hwndList, -1, LVNI_FOCUSED));
+    if (!r || r->isBrokenNetDrive || (g_view == ViewKind::Folder && !r->isDir)) return;
+    if (g_view == ViewKind::Drives)
+    {
+        // Only drives whose probe answered in time
+        const int d = r->full.empty() ? -1 : (int)towupper(r->full[0]) - L'A';
+        if (d < 0 || d >= 26 || !g_drv.drive[d].answered || g_drv.drive[d].timedOut) return;
+    }
+
+    const std::wstring folder = EnsureSlash(r->full);
+    if (NavCache_Find(folder) != g_navCache.end()) return;
+
+    // The last prefetch is still busy (maybe stuck on a dead share): try again later
+    if (g_prefetchRunning.load())
+    {
+        SetTimer(g_hwndMain, kTimerPrefetch, kPrefetchDwellMs, NULL);
+        return;
+    }
+
+    NavListing* l = new NavListing;
+    l->folder = folder;
+    l->prefetch = true;
+    l->gen = g_prefetchGen.load();
+    g_prefetchCancel = false;
+    g_prefetchRunning = true;
+    HANDLE h = CreateThread(NULL, 0, NavListProc, l, 0, NULL);
+    if (!h)
+    {
+        g_prefetchRunning = false;
+        delete l;
+        return;
+    }
+    CloseHandle(h);
+    ++g_prefetchStats.started;
+}
+
+// ----------------------------- Search (videos only, as original)
+
+// ----------------------------- Name patterns (glob / regex -> lazy DFA)
+
+// NamePattern is in namepattern.h: it needs no Win32, so it is tested on its own
+// (tests/namepattern_test.cpp).
+
+// What a search compares file names with: AND terms, or a compiled pattern.
+struct SearchMatcher
+{
+    std::vector<std::wstring> termsLower;
+    NamePattern* pattern = nullptr;
+
+    bool MatchesLower(const std::wstring& baseLower) const
+    {
+        if (pattern) return pattern->Matches(baseLower);
+        for (size_t i = 0; i < termsLower.size(); ++i)
+            if (baseLower.find(termsLower[i]) == std::wstring::npos) return false;
+        return true;
+    }
+
+    bool MatchesPath(const std::wstring& full) const
+    {
+        const wchar_t* base = wcsrchr(full.c_str(), L'\\');
+        base = base ? base + 1 : full.c_str();
+        return MatchesLower(ToLower(base));
+    }
+};
+
+static NamePattern  g_searchPattern;
+static std::wstring g_searchPatternKey;
+
+// Matcher for the current g_search query. Glob/Regex patterns are compiled
+// once per distinct query; false (with err) if the pattern does not parse.
+static bool BuildSearchMatcher(SearchMatcher& m, std::wstring* err)
+{
+    m = SearchMatcher();
+    if (g_search.mode != SearchMode::Glob && g_search.mode != SearchMode::Regex)
+    {
+        m.termsLower = g_search.termsLower;
+        return true;
+    }
+
+    const bool glob = (g_search.mode == SearchMode::Glob);
+    std::wstring key = (glob ? L"g:" : L"r:") + g_search.query;
+    if (key != g_searchPatternKey)
+    {
+        std::wstring e;
+        g_searchPatternKey = key;
+        if (!g_searchPattern.Compile(Trim(g_search.query), glob, e))
+        {
+            LogLine(L"Search pattern '%s' rejected: %s", g_search.query.c_str(), e.c_str());
+            if (err) *err = e;
+        }
+    }
+    if (!g_searchPattern.valid)
     {
-        MoveFileExW(dirNoSlash.c_str(), NULL, MOVEFILE_DELAY_UNTIL_REBOOT);
+        if (err && err->empty()) *err = L"invalid pattern";
+        return false;
+    }
+    m.pattern = &g_searchPattern;
+    return true;
+}
+
+// Search row for a file on disk; false if it is not there
+static bool SearchRowFor(const std::wstring& full, Row& r, bool withProps)
+{
+    WIN32_FILE_ATTRIBUTE_DATA fad{};
+    if (!GetFileAttributesExW(full.c_str(), GetFileExInfoStandard, &fad) ||
+            (fad.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
         return false;
+
+    r = Row();
+    r.name = full;
+    r.full = full;
+    r.isDir = false;
+    r.modified = fad.ftLastWriteTime;
+
+    ULARGE_INTEGER uli{};
+    uli.HighPart = fad.nFileSizeHigh;
+    uli.LowPart = fad.nFileSizeLow;
+    r.size = uli.QuadPart;
+
+    if (withProps) GetVideoPropsFastCached(r.full, r.vW, r.vH, r.vDur100ns);
+    return true;
+}
+
+// quiet: no progress in the title and no message pumping; stop: give up early
+static void SearchRecurseFolder(const std::wstring& folder,
+                                const SearchMatcher& match,
+                                std::vector<Row>& out,
+                                bool withProps = true,
+                                bool quiet = false,
+                                const std::atomic<bool>* stop = nullptr)
+{
+    if (!quiet) SetTitleSearchingFolder(folder);
+
+    std::wstring pat = EnsureSlash(folder) + L"*";
+    WIN32_FIND_DATAW fd;
+    ZeroMemory(&fd, sizeof(fd));
+    HANDLE h = FindFirstFileExW(pat.c_str(), FindExInfoBasic, &fd,
+                                FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+    if (h == INVALID_HANDLE_VALUE) return;
+
+    do
+    {
+        if (wcscmp(fd.cFileName, L".") == 0 || wcscmp(fd.cFileName, L"..") == 0) continue;
+        if (stop && stop->load(std::memory_order_relaxed)) break;
+
+        bool isDir = (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+        std::wstring full = EnsureSlash(folder) + fd.cFileName;
+
+        if (isDir)
+        {
+            if (fd.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) continue;
+            if (_wcsicmp(fd.cFileName, kTrashDirName) == 0) continue;
+            SearchRecurseFolder(full, match, out, withProps, quiet, stop);
+        }
+        else if (IsVideoFile(full))
+        {
+            if (match.MatchesPath(full))
+            {
+                Row r;
+                r.name = full;
+                r.full = full;
+                r.isDir = false;
+                r.modified = fd.ftLastWriteTime;
+                ULARGE_INTEGER uli;
+                uli.HighPart = fd.nFileSizeHigh;
+                uli.LowPart = fd.nFileSizeLow;
+                r.size = uli.QuadPart;
+
+                if (withProps) GetVideoPropsFastCached(r.full, r.vW, r.vH, r.vDur100ns);
+                out.push_back(r);
+            }
+        }
+    }
+    while (FindNextFileW(h, &fd));
+
+    FindClose(h);
+}
+
+// Crawl the current search scope (selection, origin folder or all drives).
+static void CrawlSearchScope(const SearchMatcher& match,
+                             std::vector<Row>& out,
+                             bool withProps)
+{
+    if (g_search.useExplicitScope)
+    {
+        for (const auto& file : g_search.explicitFiles)
+        {
+            if (!IsVideoFile(file)) continue;
+            if (!match.MatchesPath(file)) continue;
+
+            Row r;
+            if (SearchRowFor(file, r, withProps)) out.push_back(std::move(r));
+        }
+
+        for (const auto& folder : g_search.explicitFolders)
+        {
+            SetTitleSearchingFolder(folder);
+            SearchRecurseFolder(folder, match, out, withProps);
+        }
+        return;
+    }
+
+    if (g_search.originView == ViewKind::Drives)
+    {
+        DWORD mask = GetLogicalDrives();
+        for (int i = 0; i < 26; ++i)
+        {
+            if (!(mask & (1u << i))) continue;
+            wchar_t root[4] = { wchar_t(L'A' + i), L':', L'\\', 0 };
+            SetTitleSearchingFolder(root);
+            SearchRecurseFolder(root, match, out, withProps);
+        }
+    }
+    else
+    {
+        SetTitleSearchingFolder(g_search.originFolder);
+        SearchRecurseFolder(g_search.originFolder, match, out, withProps);
+    }
+}
+
+// --- Search-as-you-type: cached crawl snapshot + per-prefix candidate stack
+
+// Candidate sets for every query typed so far, over a fixed list of lower-cased
+// names. Extending the query can only narrow the set (each old term is still a
+// substring of some new term), so we filter the top level; deleting characters
+// pops back to the longest prefix already evaluated.
+struct NarrowStack
+{
+    struct Level
+    {
+        std::wstring query;
+        std::vector<uint32_t> cand;
+    };
+
+    const std::vector<std::wstring>* namesLower = nullptr;
+    std::vector<Level> levels;
+
+    void Reset(const std::vector<std::wstring>* names)
+    {
+        namesLower = names;
+        levels.clear();
+        Level base;
+        base.cand.resize(names ? names->size() : 0);
+        for (uint32_t i = 0; i < (uint32_t)base.cand.size(); ++i) base.cand[i] = i;
+        levels.push_back(std::move(base));
+    }
+
+    const std::vector<uint32_t>& Apply(const std::wstring& qLower)
+    {
+        while (levels.size() > 1 &&
+                qLower.compare(0, levels.back().query.size(), levels.back().query) != 0)
+        {
+            levels.pop_back();
+        }
+        if (levels.back().query == qLower) return levels.back().cand;
+
+        std::vector<std::wstring> terms;
+        SplitTerms(qLower, terms);
+
+        Level next;
+        next.query = qLower;
+        const std::vector<uint32_t>& from = levels.back().cand;
+        next.cand.reserve(from.size());
+        for (uint32_t idx : from)
+        {
+            const std::wstring& n = (*namesLower)[idx];
+            bool all = true;
+            for (const auto& t : terms)
+            {
+                if (n.find(t) == std::wstring::npos)
+                {
+                    all = false;
+                    break;
+                }
+            }
+            if (all) next.cand.push_back(idx);
+        }
+        levels.push_back(std::move(next));
+        return levels.back().cand;
+    }
+};
+
+// Every video file in the search scope, crawled once and reused while the
+// user refines the query. Kept current with our own file operations
+// (SearchResults_Apply) and dropped after kMaxAgeMs.
+struct SearchSnapshot
+{
+    static const DWORD kMaxAgeMs = 2 * 60 * 1000;
+
+    bool valid = false;
+    std::wstring scopeKey;
+    DWORD builtTick = 0;
+    std::vector<Row> rows;
+    std::vector<std::wstring> baseLower;   // lower-cased file names, parallel to rows
+};
+static SearchSnapshot g_searchSnap;
+static NarrowStack    g_searchNarrow;
+
+static std::wstring SearchScopeKey()
+{
+    std::wstring k;
+    if (g_search.useExplicitScope)
+    {
+        k = L"sel\n";
+        for (const auto& f : g_search.explicitFolders) k += ToLower(f) + L"\n";
+        for (const auto& f : g_search.explicitFiles) k += ToLower(f) + L"\n";
+    }
+    else if (g_search.originView == ViewKind::Drives)
+    {
+        k = L"drives\n";
+    }
+    else
+    {
+        k = L"folder\n" + ToLower(EnsureSlash(g_search.originFolder));
+    }
+    return k;
+}
+
+static void SearchRecrawl_Cancel();
+
+static void InvalidateSearchSnapshot()
+{
+    g_searchSnap.valid = false;
+    SearchRecrawl_Cancel();
+}
+
+static void EnsureSearchSnapshot()
+{
+    std::wstring key = SearchScopeKey();
+    if (g_searchSnap.valid && g_searchSnap.scopeKey == key &&
+            GetTickCount() - g_searchSnap.builtTick < SearchSnapshot::kMaxAgeMs)
+    {
+        return;
+    }
+
+    g_searchSnap = SearchSnapshot();
+    SearchMatcher all;
+    CrawlSearchScope(all, g_searchSnap.rows, false);
+
+    g_searchSnap.baseLower.reserve(g_searchSnap.rows.size());
+    for (size_t i = 0; i < g_searchSnap.rows.size(); ++i)
+    {
+        Row& r = g_searchSnap.rows[i];
+        r.snapIdx = (int)i;
+        const wchar_t* base = wcsrchr(r.full.c_str(), L'\\');
+        g_searchSnap.baseLower.push_back(ToLower(base ? base + 1 : r.full.c_str()));
+    }
+    g_searchSnap.scopeKey = key;
+    g_searchSnap.builtTick = GetTickCount();
+    g_searchSnap.valid = true;
+    g_searchNarrow.Reset(&g_searchSnap.baseLower);
+
+    LogLine(L"Search snapshot: %zu video file(s) in scope", g_searchSnap.rows.size());
+}
+
+// --- Fuzzy ranking (SearchMode::Fuzzy)
+
+static const int    kFuzzyNoMatch = INT_MIN;
+static const size_t kFuzzyTopK = 500;      // results kept per query
+
+static bool FuzzyIsWordStart(const std::wstring& s, size_t i)
+{
+    if (i == 0) return true;
+    wchar_t p = s[i - 1];
+    if (p == L' ' || p == L'.' || p == L'_' || p == L'-' ||
+            p == L'(' || p == L'[') return true;
+    return iswdigit(s[i]) && !iswdigit(p);
+}
+
+// q is a subsequence of s: score the tightest window ending at the leftmost
+// complete match. Points per matched char, bonuses for word starts and runs,
+// one point off per skipped char inside the window.
+static int FuzzySubsequenceScore(const std::wstring& q, const std::wstring& s)
+{
+    size_t qi = 0, end = 0;
+    for (size_t i = 0; i < s.size() && qi < q.size(); ++i)
+    {
+        if (s[i] == q[qi])
+        {
+            ++qi;
+            end = i;
+        }
+    }
+    if (qi < q.size()) return kFuzzyNoMatch;
+
+    size_t start = end;
+    qi = q.size();
+    for (size_t i = end + 1; i-- > 0;)
+    {
+        if (s[i] == q[qi - 1] && --qi == 0)
+        {
+            start = i;
+            break;
+        }
+    }
+
+    int score = 0, run = 0;
+    qi = 0;
+    for (size_t i = start; i <= end && qi < q.size(); ++i)
+    {
+        if (s[i] == q[qi])
+        {
+            score += 16;
+            if (FuzzyIsWordStart(s, i)) score += 8;
+            score += 4 * std::min(run, 8);
+            ++run;
+            ++qi;
+        }
+        else
+        {
+            run = 0;
+            score -= 1;
+        }
+    }
+    if (start == 0) score += 8;
+    return score;
+}
+
+// Fewest edits turning q into some substring of s (Sellers), capped at maxErr+1.
+static int FuzzyEditDistance(const std::wstring& q, const std::wstring& s,
+                             int maxErr, std::vector<int>& col)
+{
+    const size_t m = q.size();
+    col.resize(m + 1);
+    for (size_t j = 0; j <= m; ++j) col[j] = (int)j;
+
+    int best = col[m];
+    for (size_t i = 0; i < s.size() && best > 0; ++i)
+    {
+        int diag = col[0]; // free start: row 0 stays 0
+        for (size_t j = 1; j <= m; ++j)
+        {
+            int up = col[j];
+            int v = diag + (q[j - 1] == s[i] ? 0 : 1);
+            v = std::min(v, up + 1);
+            v = std::min(v, col[j - 1] + 1);
+            col[j] = v;
+            diag = up;
+        }
+        best = std::min(best, col[m]);
+    }
+    return std::min(best, maxErr + 1);
+}
+
+// Subsequence matches always outrank typo matches.
+static int FuzzyScore(const std::wstring& q, const std::wstring& s,
+                      std::vector<int>& scratch)
+{
+    int sub = FuzzySubsequenceScore(q, s);
+    if (sub != kFuzzyNoMatch) return 100000 + sub;
+
+    if (q.size() < 4) return kFuzzyNoMatch;
+    int maxErr = (q.size() <= 6) ? 1 : 2;
+    int err = FuzzyEditDistance(q, s, maxErr, scratch);
+    if (err > maxErr) return kFuzzyNoMatch;
+    return 50000 - 1000 * err;
+}
+
+typedef std::pair<int, uint32_t> FuzzyHit; // (score, snapshot index)
+
+struct FuzzyJob
+{
+    const std::vector<std::wstring>* names;
+    const std::wstring* q;
+    uint32_t begin, end;
+    std::vector<FuzzyHit> top; // min-heap of the best kFuzzyTopK
+};
+
+static DWORD WINAPI FuzzyJobProc(LPVOID p)
+{
+    FuzzyJob* job = (FuzzyJob*)p;
+    std::vector<int> scratch;
+    std::greater<FuzzyHit> minHeap;
+
+    for (uint32_t i = job->begin; i < job->end; ++i)
+    {
+        int sc = FuzzyScore(*job->q, (*job->names)[i], scratch);
+        if (sc == kFuzzyNoMatch) continue;
+
+        FuzzyHit hit(sc, i);
+        if (job->top.size() < kFuzzyTopK)
+        {
+            job->top.push_back(hit);
+            std::push_heap(job->top.begin(), job->top.end(), minHeap);
+        }
+        else if (hit > job->top.front())
+        {
+            std::pop_heap(job->top.begin(), job->top.end(), minHeap);
+            job->top.back() = hit;
+            std::push_heap(job->top.begin(), job->top.end(), minHeap);
+        }
+    }
+    return 0;
+}
+
+// Best kFuzzyTopK snapshot entries for qLower, best first. The snapshot is
+// split into one chunk per core, each keeping its own bounded heap.
+static void FuzzyRankSnapshot(const std::wstring& qLower, std::vector<uint32_t>& outIdx)
+{
+    outIdx.clear();
+
+    std::wstring q;
+    for (wchar_t c : qLower)
+        if (!iswspace(c)) q.push_back(c);
+    if (q.empty()) return;
+
+    const std::vector<std::wstring>& names = g_searchSnap.baseLower;
+    const uint32_t total = (uint32_t)names.size();
+
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    uint32_t nJobs = std::max<uint32_t>(1, std::min<uint32_t>(si.dwNumberOfProcessors, 16));
+    if (total < 8192) nJobs = 1;
+
+    std::vector<FuzzyJob> jobs(nJobs);
+    std::vector<HANDLE> threads;
+    for (uint32_t j = 0; j < nJobs; ++j)
+    {
+        jobs[j].names = &names;
+        jobs[j].q = &q;
+        jobs[j].begin = (uint32_t)((uint64_t)total * j / nJobs);
+        jobs[j].end = (uint32_t)((uint64_t)total * (j + 1) / nJobs);
+        if (j == 0) continue; // chunk 0 runs on this thread
+        HANDLE h = CreateThread(NULL, 0, FuzzyJobProc, &jobs[j], 0, NULL);
+        if (h) threads.push_back(h);
+        else FuzzyJobProc(&jobs[j]);
+    }
+    FuzzyJobProc(&jobs[0]);
+    if (!threads.empty())
+    {
+        WaitForMultipleObjects((DWORD)threads.size(), threads.data(), TRUE, INFINITE);
+        for (HANDLE h : threads) CloseHandle(h);
+    }
+
+    std::vector<FuzzyHit> all;
+    for (auto& j : jobs) all.insert(all.end(), j.top.begin(), j.top.end());
+    std::sort(all.begin(), all.end(), [&names](const FuzzyHit& a, const FuzzyHit& b)
+    {
+        if (a.first != b.first) return a.first > b.first;
+        if (names[a.second].size() != names[b.second].size())
+            return names[a.second].size() < names[b.second].size();
+        return a.second < b.second;
+    });
+    if (all.size() > kFuzzyTopK) all.resize(kFuzzyTopK);
+
+    outIdx.reserve(all.size());
+    for (const auto& h : all) outIdx.push_back(h.second);
+}
+
+// Results for the current query from the snapshot (no disk access).
+static void QuerySnapshot(std::vector<Row>& out)
+{
+    out.clear();
+    if (Trim(g_search.queryLower).empty()) return;
+
+    std::vector<uint32_t> ranked;
+    const std::vector<uint32_t>* idx = &ranked;
+    if (g_search.mode == SearchMode::Fuzzy)
+    {
+        FuzzyRankSnapshot(g_search.queryLower, ranked);
+    }
+    else if (g_search.mode == SearchMode::Words)
+    {
+        idx = &g_searchNarrow.Apply(g_search.queryLower);
+    }
+    else
+    {
+        SearchMatcher m;
+        if (!BuildSearchMatcher(m, nullptr)) return;
+        const std::vector<std::wstring>& names = g_searchSnap.baseLower;
+        for (uint32_t i = 0; i < (uint32_t)names.size(); ++i)
+            if (m.MatchesLower(names[i])) ranked.push_back(i);
+    }
+
+    out.reserve(idx->size());
+    for (uint32_t i : *idx)
+        if (!g_searchSnap.rows[i].full.empty()) out.push_back(g_searchSnap.rows[i]);
+}
+
+static void SetTitleSearchResults()
+{
+    std::wstring t = L"Browse - Search - " + JoinTermsForTitle();
+    wchar_t buf[64];
+    swprintf_s(buf, L" - %zu file(s)", g_rows.size());
+    t += buf;
+    SetWindowTextW(g_hwndMain, t.c_str());
+}
+
+// Display g_rows as search results (sorted by the current column; fuzzy
+// results keep their rank order).
+static void ShowSearchRows()
+{
+    CancelMetaWorkAndClearTodo();
+    QuickFilter_Clear();
+    FolderWatch_Stop();
+
+    g_view = ViewKind::Search;
+
+    SendMessageW(g_hwndList, WM_SETREDRAW, FALSE, 0);
+    LV_ResetColumns();
+    if (g_search.mode == SearchMode::Fuzzy) LV_Rebuild();
+    else SortRows(g_sortCol, g_sortAsc);
+    SendMessageW(g_hwndList, WM_SETREDRAW, TRUE, 0);
+    InvalidateRect(g_hwndList, NULL, TRUE);
+
+    SetTitleSearchResults();
+    QueueMissingPropsAndKickWorker();
+}
+
+// Re-display a folder listing we already hold (no enumeration).
+static void ShowFolderRows(const std::wstring& abs, std::vector<Row> rows)
+{
+    CancelMetaWorkAndClearTodo();
+    QuickFilter_Clear();
+
+    g_view = ViewKind::Folder;
+    g_folder = EnsureSlash(abs);
+    g_rows.swap(rows);
+
+    SendMessageW(g_hwndList, WM_SETREDRAW, FALSE, 0);
+    LV_ResetColumns();
+    LV_Rebuild();
+    SendMessageW(g_hwndList, WM_SETREDRAW, TRUE, 0);
+    InvalidateRect(g_hwndList, NULL, TRUE);
+
+    QueueMissingPropsAndKickWorker();
+    SetTitleFolderOrDrives();
+    FolderWatch_Start(g_folder);
+}
+
+static void ExitSearchToOrigin()
+{
+    if (!g_search.active) return;
+    if (g_search.originView == ViewKind::Drives) ShowDrives();
+    else OpenFolder(g_search.originFolder);
+    g_search = SearchState();
+}
+
+// ----------------------------- Search results after our own file operations
+//
+// Deletes, renames, moves and pastes we make ourselves are applied to the
+// search snapshot and to the results on screen directly, instead of crawling
+// the whole scope (maybe every drive) again. Rows under a deleted path go,
+// rows under a renamed path follow it and are matched against the query
+// again; only paths whose content we cannot account for (a paste destination,
+// a folder a job left half moved or half deleted) are crawled again.
+
+// What one operation did: from -> to was renamed or moved, from alone was
+// deleted, to alone holds content we know nothing about
+struct PathChange
+{
+    std::wstring from, to;
+};
+
+static bool PathIsAtOrUnder(const std::wstring& path, const std::wstring& root)
+{
+    const size_t n = root.size();
+    if (!n || path.size() < n || _wcsnicmp(path.c_str(), root.c_str(), n) != 0) return false;
+    return path.size() == n || root[n - 1] == L'\\' || path[n] == L'\\';
+}
+
+// The search crawl would reach path
+static bool InSearchScope(const std::wstring& path)
+{
+    if (!g_search.useExplicitScope)
+        return g_search.originView == ViewKind::Drives || PathIsAtOrUnder(path, g_search.originFolder);
+    for (const auto& f : g_search.explicitFiles)
+        if (_wcsicmp(f.c_str(), path.c_str()) == 0) return true;
+    for (const auto& d : g_search.explicitFolders)
+        if (PathIsAtOrUnder(path, d)) return true;
+    return false;
+}
+
+// The current query finds this file (fuzzy: with any score at all)
+static bool SearchAccepts(const std::wstring& full)
+{
+    if (!IsVideoFile(full) || !InSearchScope(full)) return false;
+    const std::wstring baseLower = ToLower(PathFindFileNameW(full.c_str()));
+    if (g_search.mode != SearchMode::Fuzzy)
+    {
+        SearchMatcher m;
+        return BuildSearchMatcher(m, nullptr) && m.MatchesLower(baseLower);
+    }
+    std::wstring q;
+    for (wchar_t c : g_search.queryLower)
+        if (!iswspace(c)) q.push_back(c);
+    std::vector<int> scratch;
+    return !q.empty() && FuzzyScore(q, baseLower, scratch) != kFuzzyNoMatch;
+}
+
+// The snapshot was built for the current scope (else it is dropped)
+static bool SearchSnap_Usable()
+{
+    if (!g_searchSnap.valid) return false;
+    if (g_searchSnap.scopeKey == SearchScopeKey()) return true;
+    InvalidateSearchSnapshot();
+    return false;
+}
+
+// Point snapshot entry i at full; empty leaves a hole so indices stay valid
+static void SearchSnap_Set(size_t i, const std::wstring& full)
+{
+    Row& r = g_searchSnap.rows[i];
+    r.full = r.name = full;
+    g_searchSnap.baseLower[i] = full.empty() ? std::wstring() : ToLower(PathFindFileNameW(full.c_str()));
+}
+
+// Paths read again off the UI thread: a paste destination can be a big tree
+// on a slow share. The result comes back as WM_APP_RECRAWL.
+constexpr UINT WM_APP_RECRAWL = WM_APP + 105;   // lParam: SearchRecrawl*
+
+struct SearchRecrawl
+{
+    struct Entry
+    {
+        std::wstring path;
+        bool keepIfDir = false;   // a renamed folder we already followed
+        bool read = false;
+        std::vector<Row> found;
+    };
+    std::vector<Entry> entries;
+    std::shared_ptr<std::atomic<bool>> stop;
+};
+
+static std::shared_ptr<std::atomic<bool>> g_recrawlStop = std::make_shared<std::atomic<bool>>(false);
+
+// The scope changed: crawls still running are of no use
+static void SearchRecrawl_Cancel()
+{
+    g_recrawlStop->store(true);
+    g_recrawlStop = std::make_shared<std::atomic<bool>>(false);
+}
+
+static DWORD WINAPI SearchRecrawlProc(LPVOID p)
+{
+    SearchRecrawl* rc = (SearchRecrawl*)p;
+    SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+    for (auto& e : rc->entries)
+    {
+        if (rc->stop->load()) break;
+        const DWORD attrs = GetFileAttributesW(e.path.c_str());
+        const bool dir = attrs != INVALID_FILE_ATTRIBUTES && (attrs & FILE_ATTRIBUTE_DIRECTORY);
+        if (dir && e.keepIfDir) continue;
+        if (dir)
+        {
+            SearchMatcher all;
+            SearchRecurseFolder(e.path, all, e.found, false, true, rc->stop.get());
+        }
+        else
+        {
+            Row r;
+            if (IsVideoFile(e.path) && SearchRowFor(e.path, r, false)) e.found.push_back(r);
+        }
+        e.read = true;
+    }
+    SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_END);
+    if (rc->stop->load() || !PostMessageW(g_hwndMain, WM_APP_RECRAWL, 0, (LPARAM)rc)) delete rc;
+    return 0;
+}
+
+// Forget what we knew at or under path and put what was read there instead
+static void SearchResults_Replace(const std::wstring& path, std::vector<Row>& found,
+                                  bool snap, bool shown, std::vector<std::wstring>& probe)
+{
+    const size_t first = g_searchSnap.rows.size();
+    if (snap)
+    {
+        for (size_t i = 0; i < first; ++i)
+        {
+            const std::wstring& full = g_searchSnap.rows[i].full;
+            if (!full.empty() && PathIsAtOrUnder(full, path)) SearchSnap_Set(i, L"");
+        }
+        for (size_t n = 0; n < found.size(); ++n)
+        {
+            found[n].snapIdx = (int)(first + n);
+            g_searchSnap.rows.push_back(found[n]);
+            g_searchSnap.baseLower.push_back(ToLower(PathFindFileNameW(found[n].full.c_str())));
+        }
+    }
+    if (!shown) return;
+
+    g_rows.erase(std::remove_if(g_rows.begin(), g_rows.end(), [&path](const Row& r)
+    {
+        return PathIsAtOrUnder(r.full, path);
+    }), g_rows.end());
+    for (Row& r : found)
+    {
+        if (!SearchAccepts(r.full)) continue;
+        if (!snap) r.snapIdx = -1;
+        if (!GetVideoPropsFastCached(r.full, r.vW, r.vH, r.vDur100ns)) probe.push_back(r.full);
+        g_rows.push_back(r);
+    }
+}
+
+// Shown results changed: re-sort, restore the selection, fetch missing props
+static void SearchResults_Show(const ListKeep& k, const std::vector<std::wstring>& probe)
+{
+    if (g_search.mode != SearchMode::Fuzzy) SortRows(g_sortCol, g_sortAsc, false);
+    LV_Restore(k);
+    QueueMetaPaths(probe);
+    if (g_inPlayback) return;
+    if (g_filterLower.empty()) SetTitleSearchResults();
+    else SetTitleFolderOrDrives();
+}
+
+// WM_APP_RECRAWL: the paths SearchResults_Apply handed off were read
+static void SearchResults_OnRecrawl(SearchRecrawl& rc)
+{
+    const bool snap = SearchSnap_Usable();
+    const bool shown = (g_view == ViewKind::Search && g_search.active);
+    if (!snap && !shown) return;
+
+    ListKeep k;
+    if (shown) k = LV_Remember();
+    std::vector<std::wstring> probe;
+    size_t read = 0;
+    for (auto& e : rc.entries)
+    {
+        if (!e.read || !InSearchScope(e.path)) continue;
+        SearchResults_Replace(e.path, e.found, snap, shown, probe);
+        ++read;
+    }
+    if (snap) g_searchNarrow.Reset(&g_searchSnap.baseLower);
+    LogLine(L"Search: %zu path(s) read again", read);
+    if (shown) SearchResults_Show(k, probe);
+}
+
+// Apply our own file operations to the snapshot and the results on screen
+static void SearchResults_Apply(const std::vector<PathChange>& changes)
+{
+    const bool snap = SearchSnap_Usable();
+    const bool shown = (g_view == ViewKind::Search && g_search.active);
+    if (changes.empty() || (!snap && !shown)) return;
+
+    // Rows are found by walking up their own path
+    std::unordered_map<std::wstring, size_t> byFrom;   // lower-case from -> change
+    for (size_t i = 0; i < changes.size(); ++i)
+        if (!changes[i].from.empty()) byFrom[ToLower(changes[i].from)] = i;
+    std::vector<bool> hit(changes.size(), false);
+    auto changeFor = [&](const std::wstring& full, std::wstring& to) -> bool
+    {
+        std::wstring key = ToLower(full);
+        for (;;)
+        {
+            auto it = byFrom.find(key);
+            if (it != byFrom.end())
+            {
+                const PathChange& c = changes[it->second];
+                hit[it->second] = true;
+                to = c.to.empty() ? c.to : c.to + full.substr(c.from.size());
+                return true;
+            }
+            size_t cut = key.find_last_of(L'\\');
+            if (cut == std::wstring::npos || cut == 0) return false;
+            key.resize(cut);
+        }
+    };
+
+    ListKeep k;
+    if (shown) k = LV_Remember();
+    std::wstring to;
+    if (snap && !byFrom.empty())
+    {
+        for (size_t i = 0; i < g_searchSnap.rows.size(); ++i)
+        {
+            const std::wstring& full = g_searchSnap.rows[i].full;
+            if (full.empty() || !changeFor(full, to)) continue;
+            SearchSnap_Set(i, !to.empty() && IsVideoFile(to) && InSearchScope(to) ? to : std::wstring());
+        }
+    }
+    if (shown && !byFrom.empty())
+    {
+        for (size_t i = g_rows.size(); i-- > 0; )
+        {
+            Row& r = g_rows[i];
+            if (!changeFor(r.full, to)) continue;
+            if (to.empty() || !SearchAccepts(to))
+            {
+                g_rows.erase(g_rows.begin() + i);
+                continue;
+            }
+            r.full = r.name = to;
+            r.nameLower.clear();
+        }
+    }
+
+    // A renamed file is matched again from disk (it may match only now); a
+    // renamed folder we knew nothing in is read only if it came into scope
+    SearchRecrawl* rc = new SearchRecrawl;
+    rc->stop = g_recrawlStop;
+    for (size_t i = 0; i < changes.size(); ++i)
+    {
+        const PathChange& c = changes[i];
+        if (c.to.empty() || !InSearchScope(c.to)) continue;
+        SearchRecrawl::Entry e;
+        e.path = c.to;
+        e.keepIfDir = !c.from.empty() && (hit[i] || InSearchScope(c.from));
+        rc->entries.push_back(std::move(e));
+    }
+    const size_t reading = rc->entries.size();
+    if (reading)
+    {
+        HANDLE h = CreateThread(NULL, 0, SearchRecrawlProc, rc, 0, NULL);
+        if (h) CloseHandle(h);
+        else delete rc;
+    }
+    else
+    {
+        delete rc;
+    }
+
+    if (snap) g_searchNarrow.Reset(&g_searchSnap.baseLower);
+    LogLine(L"Search: %zu change(s) applied, %zu path(s) to read again", changes.size(), reading);
+    if (shown) SearchResults_Show(k, {});
+}
+
+// ----------------------------- File operations
+
+// Destination names for a whole paste. The folder is listed once into a
+// case-insensitive set and "name (n).ext" collisions are settled in memory;
+// names handed out are added to the set, so entries of one paste never pick
+// the same name. Claim() is the fallback for a name that turns up on disk
+// after the listing: it creates the next free name exclusively.
+struct NameResolver
+{
+    std::wstring folder;                         // with trailing slash
+    std::unordered_set<std::wstring> taken;      // lower-case names
+    std::unordered_map<std::wstring, int> next;  // lower-case base+ext -> next (n) to try
+
+    void Load(const std::wstring& dir)
+    {
+        folder = EnsureSlash(dir);
+        taken.clear();
+        next.clear();
+
+        WIN32_FIND_DATAW fd;
+        HANDLE h = FindFirstFileExW((folder + L"*").c_str(), FindExInfoBasic, &fd,
+                                    FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+        if (h == INVALID_HANDLE_VALUE) return;
+        do
+        {
+            if (wcscmp(fd.cFileName, L".") == 0 || wcscmp(fd.cFileName, L"..") == 0) continue;
+            taken.insert(ToLower(fd.cFileName));
+        } while (FindNextFileW(h, &fd));
+        FindClose(h);
+    }
+
+    // Full path of the first free "base ext" / "base (n)ext"; reserves it.
+    std::wstring Resolve(const std::wstring& base, const std::wstring& ext)
+    {
+        const std::wstring key = ToLower(base + ext);
+        int& n = next[key];
+        for (; n < 10000; ++n)
+        {
+            std::wstring name = base;
+            if (n)
+            {
+                wchar_t buf[32];
+                swprintf_s(buf, L" (%d)", n);
+                name += buf;
+            }
+            name += ext;
+            if (taken.insert(ToLower(name)).second)
+            {
+                ++n;
+                return folder + name;
+            }
+        }
+        return folder + base + ext;
+    }
+
+    // Resolve and create the name exclusively (empty file or directory),
+    // skipping names that already exist on disk.
+    std::wstring Claim(const std::wstring& base, const std::wstring& ext, bool dir)
+    {
+        for (int tries = 0; tries < 10000; ++tries)
+        {
+            std::wstring t = Resolve(base, ext);
+            bool ok;
+            if (dir)
+            {
+                ok = CreateDirectoryW(t.c_str(), NULL) != FALSE;
+            }
+            else
+            {
+                HANDLE h = CreateFileW(t.c_str(), GENERIC_WRITE, 0, NULL, CREATE_NEW,
+                                       FILE_ATTRIBUTE_NORMAL, NULL);
+                ok = (h != INVALID_HANDLE_VALUE);
+                if (ok) CloseHandle(h);
+            }
+            if (ok) return t;
+            DWORD err = GetLastError();
+            if (err != ERROR_FILE_EXISTS && err != ERROR_ALREADY_EXISTS) return t;
+        }
+        return folder + base + ext;
+    }
+};
+
+// Clipboard: now includes files AND directories
+static void Browser_CopySelectedToClipboard(ClipMode mode)
+{
+    g_clipFiles.clear();
+    g_clipMode = ClipMode::None;
+    if (g_view == ViewKind::Drives) return;
+
+    std::vector<int> selectedIdx; // g_rows indices
+    int idx = -1;
+    while ((idx = ListView_GetNextItem(g_hwndList, idx, LVNI_SELECTED)) != -1)
+    {
+        const Row* r = RowAt(idx);
+        if (!r) continue;
+        g_clipFiles.push_back(r->full);
+        selectedIdx.push_back(g_visible[idx]);
+    }
+    if (g_clipFiles.empty()) return;
+
+    g_clipMode = mode;
+
+    if (mode == ClipMode::Move)
+    {
+        std::sort(selectedIdx.begin(), selectedIdx.end());
+        for (int n = (int)selectedIdx.size() - 1; n >= 0; --n)
+        {
+            int rIdx = selectedIdx[n];
+            if (rIdx >= 0 && rIdx < (int)g_rows.size())
+            {
+                g_rows.erase(g_rows.begin() + rIdx);
+            }
+        }
+        RebuildVisible(false);
+        LV_SyncItemCount(true);
+    }
+    // NEW: also publish to the system clipboard as CF_HDROP so that
+    // Explorer / Remote Desktop etc. can see the file list.
+    SetClipboardFileDrop(g_clipFiles, mode);
+
+}
+
+// ----------------------------- DPI helpers
+
+typedef UINT(WINAPI* GetDpiForWindow_t)(HWND);
+static int DpiScale(int px)
+{
+    UINT dpi = 96;
+    HMODULE m = GetModuleHandleW(L"user32.dll");
+    if (m)
+    {
+        GetDpiForWindow_t p = (GetDpiForWindow_t)GetProcAddress(m, "GetDpiForWindow");
+        if (p) dpi = p(g_hwndMain ? g_hwndMain : GetDesktopWindow());
+    }
+    return MulDiv(px, dpi, 96);
+}
+
+// ----------------------------- Transfer statistics
+
+// Byte-accurate progress for one copy job. Totals come from the pre-scan, the
+// job thread's tick feeds Sample() and workers report every finished file's latency.
+
+static const int    kLatencyBuckets = 6;       // <10ms, <100ms, <1s, <10s, <1min, longer
+static const double kRateTauMs = 5000.0;       // throughput averaging window
+
+struct TransferStats
+{
+    ULONGLONG totalBytes = 0;
+    size_t    totalFiles = 0;
+    ULONGLONG startTick = 0, startBytes = 0;   // startBytes: done by an earlier run
+    ULONGLONG sampleTick = 0, sampleBytes = 0; // last rate sample
+    ULONGLONG seenBytes = 0, movedTick = 0;    // for stall detection
+    double    rate = 0.0;                      // bytes/s, moving average
+    std::atomic<unsigned>  latency[kLatencyBuckets] = {};
+    std::atomic<ULONGLONG> slowestMs{ 0 };
+
+    void Begin(ULONGLONG bytes, size_t files, ULONGLONG alreadyDone = 0)
+    {
+        totalBytes = bytes;
+        totalFiles = files;
+        startBytes = sampleBytes = seenBytes = alreadyDone;
+        startTick = sampleTick = movedTick = GetTickCount64();
+    }
+
+    // Job thread, about every 100 ms
+    void Sample(ULONGLONG bytesDone)
+    {
+        ULONGLONG now = GetTickCount64();
+        if (bytesDone != seenBytes)
+        {
+            seenBytes = bytesDone;
+            movedTick = now;
+        }
+        ULONGLONG dt = now - sampleTick;
+        if (dt < 500) return; // too short for a stable instantaneous rate
+        double inst = (double)(bytesDone - sampleBytes) * 1000.0 / (double)dt;
+        rate = (rate == 0.0) ? inst : rate + (inst - rate) * (dt / (kRateTauMs + dt));
+        sampleTick = now;
+        sampleBytes = bytesDone;
+    }
+
+    // Any thread
+    void RecordFile(ULONGLONG ms)
+    {
+        int b = ms < 10 ? 0 : ms < 100 ? 1 : ms < 1000 ? 2 : ms < 10000 ? 3 : ms < 60000 ? 4 : 5;
+        latency[b].fetch_add(1, std::memory_order_relaxed);
+        ULONGLONG cur = slowestMs.load(std::memory_order_relaxed);
+        while (ms > cur && !slowestMs.compare_exchange_weak(cur, ms)) {}
+    }
+
+    ULONGLONG ElapsedMs() const { return GetTickCount64() - startTick; }
+    ULONGLONG StalledMs() const { return GetTickCount64() - movedTick; }
+
+    double AverageRate(ULONGLONG bytesDone) const
+    {
+        ULONGLONG ms = ElapsedMs();
+        return ms ? (double)(bytesDone - startBytes) * 1000.0 / (double)ms : 0.0;
+    }
+
+    // -1 while there is no rate to extrapolate from
+    LONGLONG EtaMs(ULONGLONG bytesDone) const
+    {
+        if (rate <= 0.0 || bytesDone >= totalBytes) return bytesDone >= totalBytes ? 0 : -1;
+        return (LONGLONG)((double)(totalBytes - bytesDone) * 1000.0 / rate);
+    }
+
+    // Two lines for the progress window
+    std::wstring Describe(ULONGLONG bytesDone) const
+    {
+        wchar_t buf[256];
+        unsigned pct = totalBytes ? (unsigned)(bytesDone * 100 / totalBytes) : 100;
+        LONGLONG eta = EtaMs(bytesDone);
+        swprintf_s(buf, L"%s of %s (%u%%), %s/s, %s left\n",
+                   FormatSize(bytesDone).c_str(), FormatSize(totalBytes).c_str(), pct,
+                   FormatSize((ULONGLONG)rate).c_str(),
+                   eta < 0 ? L"--:--" : FormatHMSms(eta).c_str());
+        std::wstring s = buf;
+        if (StalledMs() >= 5000)
+            swprintf_s(buf, L"No progress for %s (elapsed %s)",
+                       FormatHMSms((LONGLONG)StalledMs()).c_str(),
+                       FormatHMSms((LONGLONG)ElapsedMs()).c_str());
+        else
+            swprintf_s(buf, L"Average %s/s, elapsed %s",
+                       FormatSize((ULONGLONG)AverageRate(bytesDone)).c_str(),
+                       FormatHMSms((LONGLONG)ElapsedMs()).c_str());
+        return s + buf;
+    }
+
+    // One line for browse.log
+    std::wstring Summary(ULONGLONG bytesDone, size_t filesDone) const
+    {
+        wchar_t buf[320];
+        swprintf_s(buf, L"%zu/%zu file(s), %llu/%llu bytes in %s, avg %.1f MB/s; "
+                   L"file latency <10ms:%u <100ms:%u <1s:%u <10s:%u <1m:%u longer:%u, slowest %llu ms",
+                   filesDone, totalFiles, bytesDone, totalBytes,
+                   FormatHMSms((LONGLONG)ElapsedMs()).c_str(),
+                   AverageRate(bytesDone) / 1048576.0,
+                   latency[0].load(), latency[1].load(), latency[2].load(),
+                   latency[3].load(), latency[4].load(), latency[5].load(),
+                   slowestMs.load());
+        return buf;
+    }
+};
+
+// ---------- Background jobs (paste, delete, post-playback actions)
+//
+// Long operations run as jobs on their own threads, so browsing and playback
+// stay responsive. The UI thread owns g_jobs: it queues jobs, runs up to
+// kMaxRunningJobs at once and hears about each finished one through
+// WM_APP_JOB. The Jobs panel (Ctrl+J) shows progress and can pause, cancel
+// and retry them.
+
+enum class JobState { Queued, Running, Paused, Done, Failed, Cancelled };
+
+static const size_t kMaxRunningJobs = 3;
+constexpr UINT WM_APP_JOB = WM_APP + 101;   // wParam: job id
+
+struct Job
+{
+    int id = 0;
+    std::wstring title;
+    std::function<bool(Job&)> run;        // job thread; false = failed
+    std::function<void(Job&)> finished;   // UI thread, after every run
+    std::vector<std::wstring> touched;    // folders shown fresh when it ends
+    bool retry = false;                   // run() again after a failure or cancel
+
+    std::atomic<JobState> state{ JobState::Queued };
+    std::atomic<bool> cancel{ false };
+    std::atomic<bool> paused{ false };
+    std::atomic<int>  permille{ -1 };     // -1: no byte progress
+    HANDLE thread = NULL;
+
+    CRITICAL_SECTION lock;                // status, detail
+    std::wstring status, detail;
+
+    Job() { InitializeCriticalSection(&lock); }
+    ~Job() { DeleteCriticalSection(&lock); }
+
+    bool Cancelled() const
+    {
+        return cancel.load(std::memory_order_relaxed);
+    }
+
+    // Job thread: parks while paused. False once the job is cancelled.
+    bool WaitWhilePaused() const
+    {
+        while (paused.load(std::memory_order_relaxed) && !Cancelled()) Sleep(100);
+        return !Cancelled();
+    }
+
+    void SetStatus(const std::wstring& s)
+    {
+        EnterCriticalSection(&lock);
+        status = s;
+        LeaveCriticalSection(&lock);
+    }
+
+    void SetDetail(const std::wstring& d, int pm)
+    {
+        EnterCriticalSection(&lock);
+        detail = d;
+        LeaveCriticalSection(&lock);
+        permille.store(pm, std::memory_order_relaxed);
+    }
+
+    void GetText(std::wstring& s, std::wstring& d)
+    {
+        EnterCriticalSection(&lock);
+        s = status;
+        d = detail;
+        LeaveCriticalSection(&lock);
+    }
+};
+
+static std::vector<std::shared_ptr<Job>> g_jobs;   // UI thread only
+static int g_jobNextId = 0;
+
+static const wchar_t* JobStateName(JobState s)
+{
+    switch (s)
+    {
+    case JobState::Queued:    return L"Queued";
+    case JobState::Running:   return L"Running";
+    case JobState::Paused:    return L"Paused";
+    case JobState::Done:      return L"Done";
+    case JobState::Failed:    return L"Failed";
+    case JobState::Cancelled: return L"Cancelled";
+    }
+    return L"";
+}
+
+static bool JobActive(const Job& j)
+{
+    JobState s = j.state.load();
+    return s == JobState::Queued || s == JobState::Running || s == JobState::Paused;
+}
+
+static DWORD WINAPI JobThreadProc(LPVOID p)
+{
+    Job& job = *(Job*)p;
+    bool ok = job.run(job);
+    job.state = job.Cancelled() ? JobState::Cancelled : ok ? JobState::Done : JobState::Failed;
+    PostMessageW(g_hwndMain, WM_APP_JOB, (WPARAM)job.id, 0);
+    return 0;
+}
+
+// ----- Jobs panel
+
+struct JobsPanelUI
+{
+    HWND hwnd{}, hList{}, hBar{}, hDetail{};
+    HWND hPause{}, hCancel{}, hRetry{}, hClear{};
+} g_jobsUI;
+
+enum { IDC_JOB_PAUSE = 201, IDC_JOB_CANCEL, IDC_JOB_RETRY, IDC_JOB_CLEAR };
+
+static Job* JobsPanel_Selected()
+{
+    if (!g_jobsUI.hList) return nullptr;
+    int sel = ListView_GetNextItem(g_jobsUI.hList, -1, LVNI_SELECTED);
+    return (sel >= 0 && sel < (int)g_jobs.size()) ? g_jobs[sel].get() : nullptr;
+}
+
+// Re-read every job into the list; rows are g_jobs in order
+static void JobsPanel_Update()
+{
+    if (!g_jobsUI.hwnd) return;
+    HWND lv = g_jobsUI.hList;
+    int count = ListView_GetItemCount(lv);
+    while (count > (int)g_jobs.size()) ListView_DeleteItem(lv, --count);
+
+    for (int i = 0; i < (int)g_jobs.size(); ++i)
+    {
+        Job& j = *g_jobs[i];
+        std::wstring status, detail;
+        j.GetText(status, detail);
+        if (i >= count)
+        {
+            LVITEMW it{};
+            it.mask = LVIF_TEXT;
+            it.iItem = i;
+            it.pszText = (LPWSTR)j.title.c_str();
+            ListView_InsertItem(lv, &it);
+            ++count;
+        }
+        else
+        {
+            ListView_SetItemText(lv, i, 0, (LPWSTR)j.title.c_str());
+        }
+        ListView_SetItemText(lv, i, 1, (LPWSTR)JobStateName(j.state.load()));
+        ListView_SetItemText(lv, i, 2, (LPWSTR)status.c_str());
+    }
+
+    Job* sel = JobsPanel_Selected();
+    std::wstring status, detail;
+    if (sel) sel->GetText(status, detail);
+    int pm = sel ? sel->permille.load() : -1;
+    ShowWindow(g_jobsUI.hBar, pm >= 0 ? SW_SHOWNA : SW_HIDE);
+    if (pm >= 0) SendMessageW(g_jobsUI.hBar, PBM_SETPOS, pm, 0);
+    SetWindowTextW(g_jobsUI.hDetail, detail.c_str());
+
+    const JobState st = sel ? sel->state.load() : JobState::Done;
+    EnableWindow(g_jobsUI.hPause, st == JobState::Running || st == JobState::Paused);
+    SetWindowTextW(g_jobsUI.hPause, st == JobState::Paused ? L"Resume" : L"Pause");
+    EnableWindow(g_jobsUI.hCancel, sel && JobActive(*sel));
+    EnableWindow(g_jobsUI.hRetry, sel && (st == JobState::Failed || st == JobState::Cancelled) &&
+                 !sel->thread);
+}
+
+static void Jobs_Schedule();
+static void Jobs_Command(int id);
+
+static LRESULT CALLBACK JobsPanelProc(HWND h, UINT m, WPARAM w, LPARAM l)
+{
+    switch (m)
+    {
+    case WM_CREATE:
+    {
+        HFONT hf = (HFONT)GetStockObject(DEFAULT_GUI_FONT);
+        g_jobsUI.hList = CreateWindowExW(
+                             WS_EX_CLIENTEDGE, WC_LISTVIEWW, L"",
+                             WS_CHILD | WS_VISIBLE | LVS_REPORT | LVS_SINGLESEL | LVS_SHOWSELALWAYS,
+                             0, 0, 0, 0, h, (HMENU)200, g_hInst, NULL);
+        ListView_SetExtendedListViewStyle(g_jobsUI.hList, LVS_EX_FULLROWSELECT | LVS_EX_DOUBLEBUFFER);
+        const wchar_t* cols[] = { L"Job", L"State", L"Progress" };
+        const int widths[] = { 220, 70, 300 };
+        for (int i = 0; i < 3; ++i)
+        {
+            LVCOLUMNW c{};
+            c.mask = LVCF_TEXT | LVCF_WIDTH;
+            c.pszText = (LPWSTR)cols[i];
+            c.cx = DpiScale(widths[i]);
+            ListView_InsertColumn(g_jobsUI.hList, i, &c);
+        }
+
+        g_jobsUI.hBar = CreateWindowExW(0, PROGRESS_CLASSW, L"", WS_CHILD | PBS_SMOOTH,
+                                        0, 0, 0, 0, h, NULL, g_hInst, NULL);
+        SendMessageW(g_jobsUI.hBar, PBM_SETRANGE32, 0, 1000);
+        g_jobsUI.hDetail = CreateWindowExW(0, L"STATIC", L"", WS_CHILD | WS_VISIBLE | SS_LEFT,
+                                           0, 0, 0, 0, h, NULL, g_hInst, NULL);
+        SendMessageW(g_jobsUI.hDetail, WM_SETFONT, (WPARAM)hf, TRUE);
+
+        HWND* btns[] = { &g_jobsUI.hPause, &g_jobsUI.hCancel, &g_jobsUI.hRetry, &g_jobsUI.hClear };
+        const wchar_t* names[] = { L"Pause", L"Cancel", L"Retry", L"Clear finished" };
+        for (int i = 0; i < 4; ++i)
+        {
+            *btns[i] = CreateWindowExW(0, L"BUTTON", names[i], WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON,
+                                       0, 0, 0, 0, h, (HMENU)(INT_PTR)(IDC_JOB_PAUSE + i), g_hInst, NULL);
+            SendMessageW(*btns[i], WM_SETFONT, (WPARAM)hf, TRUE);
+        }
+        SetTimer(h, kTimerJobsPanel, 250, NULL);
+        return 0;
+    }
+    case WM_SIZE:
+    {
+        RECT rc{};
+        GetClientRect(h, &rc);
+        int margin = DpiScale(8);
+        int btnW = DpiScale(100), btnH = DpiScale(26);
+        int bottom = rc.bottom - margin - btnH;
+        int detailH = DpiScale(32), barH = DpiScale(14);
+        int listH = bottom - margin - detailH - barH - 3 * margin;
+        MoveWindow(g_jobsUI.hList, margin, margin, rc.right - 2 * margin, listH, TRUE);
+        MoveWindow(g_jobsUI.hBar, margin, margin * 2 + listH, rc.right - 2 * margin, barH, TRUE);
+        MoveWindow(g_jobsUI.hDetail, margin, margin * 3 + listH + barH,
+                   rc.right - 2 * margin, detailH, TRUE);
+        HWND btns[] = { g_jobsUI.hPause, g_jobsUI.hCancel, g_jobsUI.hRetry, g_jobsUI.hClear };
+        for (int i = 0; i < 4; ++i)
+            MoveWindow(btns[i], margin + i * (btnW + margin), bottom, btnW, btnH, TRUE);
+        return 0;
+    }
+    case WM_TIMER:
+        if (w == kTimerJobsPanel && IsWindowVisible(h)) JobsPanel_Update();
+        return 0;
+    case WM_NOTIFY:
+        // Selection changes only; JobsPanel_Update's own text updates notify too
+        if (((LPNMHDR)l)->hwndFrom == g_jobsUI.hList && ((LPNMHDR)l)->code == LVN_ITEMCHANGED &&
+                (((NMLISTVIEW*)l)->uChanged & LVIF_STATE))
+            JobsPanel_Update();
+        break;
+    case WM_COMMAND:
+        if (LOWORD(w) >= IDC_JOB_PAUSE && LOWORD(w) <= IDC_JOB_CLEAR)
+        {
+            Jobs_Command(LOWORD(w));
+            return 0;
+        }
+        if (LOWORD(w) == IDCANCEL)
+        {
+            ShowWindow(h, SW_HIDE);
+            return 0;
+        }
+        break;
+    case WM_CLOSE:
+        ShowWindow(h, SW_HIDE);   // jobs keep running
+        return 0;
+    case WM_DESTROY:
+        KillTimer(h, kTimerJobsPanel);
+        g_jobsUI = JobsPanelUI();
+        return 0;
+    }
+    return DefWindowProcW(h, m, w, l);
+}
+
+// Show the panel (created on first use); activate=false leaves focus alone
+static void JobsPanel_Show(bool activate)
+{
+    if (!g_jobsUI.hwnd)
+    {
+        WNDCLASSW wc{};
+        wc.lpfnWndProc = JobsPanelProc;
+        wc.hInstance = g_hInst;
+        wc.hCursor = LoadCursor(NULL, IDC_ARROW);
+        wc.hbrBackground = (HBRUSH)(COLOR_BTNFACE + 1);
+        wc.lpszClassName = L"BrowseJobsPanel";
+        RegisterClassW(&wc);
+
+        // Bottom-right of the main window
+        RECT rm{};
+        GetWindowRect(g_hwndMain, &rm);
+        int W = DpiScale(640), H = DpiScale(300);
+        g_jobsUI.hwnd = CreateWindowExW(
+                            WS_EX_TOOLWINDOW, L"BrowseJobsPanel", L"Jobs",
+                            WS_POPUP | WS_CAPTION | WS_SYSMENU | WS_THICKFRAME,
+                            rm.right - W - DpiScale(16), rm.bottom - H - DpiScale(16), W, H,
+                            g_hwndMain, NULL, g_hInst, NULL);
+        if (!g_jobsUI.hwnd) return;
+    }
+    JobsPanel_Update();
+    ShowWindow(g_jobsUI.hwnd, activate ? SW_SHOW : SW_SHOWNA);
+    if (activate) SetFocus(g_jobsUI.hList);
+}
+
+static void JobsPanel_Toggle()
+{
+    if (g_jobsUI.hwnd && IsWindowVisible(g_jobsUI.hwnd)) ShowWindow(g_jobsUI.hwnd, SW_HIDE);
+    else JobsPanel_Show(true);
+}
+
+// ----- Queue
+
+static void Jobs_Schedule()
+{
+    size_t running = 0;
+    for (const auto& j : g_jobs)
+        if (j->thread) ++running;
+
+    for (const auto& j : g_jobs)
+    {
+        if (running >= kMaxRunningJobs) break;
+        if (j->thread || j->state.load() != JobState::Queued) continue;
+        j->state = JobState::Running;
+        j->thread = CreateThread(NULL, 0, JobThreadProc, j.get(), 0, NULL);
+        if (!j->thread)
+        {
+            j->state = JobState::Failed;
+            j->SetStatus(L"Could not start");
+            continue;
+        }
+        ++running;
+        LogLine(L"Job %d started: %s%s", j->id, j->title.c_str(), j->retry ? L" (retry)" : L"");
+    }
+    JobsPanel_Update();
+}
+
+static void Jobs_Add(const std::shared_ptr<Job>& job)
+{
+    job->id = ++g_jobNextId;
+    job->SetStatus(L"Waiting");
+    g_jobs.push_back(job);
+    LogLine(L"Job %d queued: %s", job->id, job->title.c_str());
+    if (!g_inPlayback) JobsPanel_Show(false);
+    Jobs_Schedule();
+}
+
+static bool g_jobsStaleView = false;   // touched while the list was hidden by playback
+
+static void Jobs_RefreshTouched(const Job& job)
+{
+    if (g_view != ViewKind::Folder || FolderWatch_Live()) return;
+    const std::wstring cur = EnsureSlash(g_folder);
+    for (const auto& f : job.touched)
+    {
+        if (_wcsicmp(EnsureSlash(f).c_str(), cur.c_str()) == 0)
+        {
+            if (g_inPlayback) g_jobsStaleView = true;
+            else ShowFolder(g_folder);
+            return;
+        }
+    }
+}
+
+// WM_APP_JOB: the job's thread is done
+static void Jobs_OnFinished(int id)
+{
+    // Hold on to it: finished() may queue more jobs
+    std::shared_ptr<Job> j;
+    for (const auto& k : g_jobs)
+        if (k->id == id && k->thread) j = k;
+
+    if (j)
+    {
+        WaitForSingleObject(j->thread, INFINITE);
+        CloseHandle(j->thread);
+        j->thread = NULL;
+
+        std::wstring status, detail;
+        j->GetText(status, detail);
+        LogLine(L"Job %d %s: %s (%s)", j->id, JobStateName(j->state.load()),
+                j->title.c_str(), status.c_str());
+        if (j->finished) j->finished(*j);
+        Jobs_RefreshTouched(*j);
+        if (j->state.load() == JobState::Failed && !g_inPlayback) JobsPanel_Show(false);
+    }
+    Jobs_Schedule();
+}
+
+static void Jobs_Command(int id)
+{
+    if (id == IDC_JOB_CLEAR)
+    {
+        g_jobs.erase(std::remove_if(g_jobs.begin(), g_jobs.end(),
+                                    [](const std::shared_ptr<Job>& j)
+        {
+            return !j->thread && !JobActive(*j);
+        }), g_jobs.end());
+        JobsPanel_Update();
+        return;
+    }
+
+    Job* j = JobsPanel_Selected();
+    if (!j) return;
+    const JobState st = j->state.load();
+    switch (id)
+    {
+    case IDC_JOB_PAUSE:
+        // The job thread may have finished meanwhile: never overwrite that
+        if (st == JobState::Running || st == JobState::Paused)
+        {
+            const bool pause = (st == JobState::Running);
+            JobState from = st;
+            if (j->state.compare_exchange_strong(from, pause ? JobState::Paused : JobState::Running))
+                j->paused = pause;
+        }
+        break;
+    case IDC_JOB_CANCEL:
+    {
+        j->cancel = true;
+        j->paused = false;
+        JobState from = st;
+        if (st == JobState::Queued) j->state.compare_exchange_strong(from, JobState::Cancelled);
+        else if (st == JobState::Paused) j->state.compare_exchange_strong(from, JobState::Running);
+        break;
+    }
+    case IDC_JOB_RETRY:
+        if ((st == JobState::Failed || st == JobState::Cancelled) && !j->thread)
+        {
+            j->cancel = false;
+            j->paused = false;
+            j->retry = true;
+            j->SetDetail(L"", -1);
+            j->SetStatus(L"Waiting");
+            j->state = JobState::Queued;
+        }
+        break;
+    }
+    Jobs_Schedule();
+}
+
+static size_t Jobs_ActiveCount()
+{
+    size_t n = 0;
+    for (const auto& j : g_jobs)
+        if (JobActive(*j)) ++n;
+    return n;
+}
+
+// Exit: cancel everything and give the threads a moment to stop. Pastes
+// keep their journal, so they can be resumed next time.
+static bool g_jobsStuck = false;   // a job thread outlived Jobs_Shutdown: exit hard
+
+// Cancel every job and wait for its thread. A thread stuck in I/O (a dead
+// share) is left running: its job is kept alive on purpose, and WinMain ends
+// with ExitProcess so static teardown never frees what it still uses.
+static void Jobs_Shutdown()
+{
+    for (const auto& j : g_jobs)
+    {
+        j->cancel = true;
+        j->paused = false;
+    }
+    const ULONGLONG deadline = GetTickCount64() + 10000;
+    for (const auto& j : g_jobs)
+    {
+        if (!j->thread) continue;
+        const ULONGLONG now = GetTickCount64();
+        if (WaitForSingleObject(j->thread, now < deadline ? (DWORD)(deadline - now) : 0) != WAIT_OBJECT_0)
+        {
+            LogLine(L"Jobs: \"%s\" did not stop, leaving it at exit", j->title.c_str());
+            new std::shared_ptr<Job>(j);   // never freed
+            g_jobsStuck = true;
+            continue;
+        }
+        CloseHandle(j->thread);
+        j->thread = NULL;
+    }
+    if (g_jobsUI.hwnd) DestroyWindow(g_jobsUI.hwnd);
+}
+
+static bool SameVolume(const std::wstring& a, const std::wstring& b)
+{
+    wchar_t va[MAX_PATH] {}, vb[MAX_PATH] {};
+    if (!GetVolumePathNameW(a.c_str(), va, MAX_PATH)) return false;
+    if (!GetVolumePathNameW(b.c_str(), vb, MAX_PATH)) return false;
+    return _wcsicmp(va, vb) == 0;
+}
+
+// Recursive directory helpers
+
+// Parallel delete engine. Directories are enumerated by a pool of workers,
+// so independent subtrees are cleared concurrently; files are deleted using
+// the attributes enumeration already returned. Every directory counts its
+// own enumeration plus its unfinished subdirectories, and is removed when
+// that count drops to zero, so directories go bottom-up.
+// - Reparse-point dirs (junctions/symlink dirs): do NOT recurse into target,
+//   just remove the link itself (RemoveDirectoryW).
+
+static const int kDeleteMaxThreads = 8;
+
+struct DeleteNode
+{
+    std::wstring path;              // with trailing slash
+    DeleteNode* parent = nullptr;
+    DWORD attrs = 0;
+    std::atomic<int> pending{ 1 };  // own enumeration + unfinished child dirs
+};
+
+struct DeleteTreeJob
+{
+    CRITICAL_SECTION lock;           // queue, nodes, busy, done
+    CONDITION_VARIABLE cv;
+    std::vector<DeleteNode*> queue;  // directories waiting to be enumerated
+    std::deque<DeleteNode> nodes;    // owns every node (stable addresses)
+    int busy = 0;
+    bool done = false;
+
+    IoDevice* dev = nullptr;
+    bool background = false;         // purge: low priority, pause during playback
+    const std::atomic<bool>* cancel = nullptr;  // owning job's, if any
+    const std::atomic<bool>* paused = nullptr;
+    bool rootRemoved = false;
+    std::atomic<size_t> files{ 0 }, dirs{ 0 }, failures{ 0 };
+
+    DeleteTreeJob()
+    {
+        InitializeCriticalSection(&lock);
+        InitializeConditionVariable(&cv);
+    }
+    ~DeleteTreeJob() { DeleteCriticalSection(&lock); }
+
+    bool Cancelled() const
+    {
+        return cancel && cancel->load(std::memory_order_relaxed);
+    }
+};
+
+static void DeleteTree_ClearAttrs(const std::wstring& path, DWORD attrs)
+{
+    if (attrs & (FILE_ATTRIBUTE_READONLY | FILE_ATTRIBUTE_SYSTEM))
+        SetFileAttributesW(path.c_str(), attrs & ~(FILE_ATTRIBUTE_READONLY | FILE_ATTRIBUTE_SYSTEM));
+}
+
+// One step of enumeration (or one child dir) is done: remove every directory
+// that has nothing left, walking up.
+static void DeleteTree_Finish(DeleteTreeJob& job, DeleteNode* node)
+{
+    while (node && node->pending.fetch_sub(1) == 1)
+    {
+        std::wstring dir = node->path;
+        while (dir.size() > 1 && (dir.back() == L'\\' || dir.back() == L'/') && !IsDriveRoot(dir))
+            dir.pop_back();
+        DeleteTree_ClearAttrs(dir, node->attrs);
+        bool ok = RemoveDirectoryW(dir.c_str()) != FALSE;
+        if (ok)
+        {
+            job.dirs.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            MoveFileExW(dir.c_str(), NULL, MOVEFILE_DELAY_UNTIL_REBOOT);
+            job.failures.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (!node->parent) job.rootRemoved = ok;
+        node = node->parent;
+    }
+}
+
+static void DeleteTree_Process(DeleteTreeJob& job, DeleteNode* node)
+{
+    if (job.background)
+        while (g_govPlayback.load(std::memory_order_relaxed)) Sleep(500);
+    IoSlot slot(job.dev, nullptr, job.cancel);
+    if (!slot.ok) return;
+    slot.paused = job.paused;
+
+    // A cancelled delete leaves what it has not reached, and does not mark
+    // the directories it stopped in for removal at reboot
+    bool stopped = false;
+    WIN32_FIND_DATAW fd{};
+    HANDLE h = FindFirstFileExW((node->path + L"*").c_str(), FindExInfoBasic, &fd,
+                                FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+    if (h != INVALID_HANDLE_VALUE)
+    {
+        do
+        {
+            if (wcscmp(fd.cFileName, L".") == 0 || wcscmp(fd.cFileName, L"..") == 0) continue;
+            if (!slot.Checkpoint())
+            {
+                stopped = true;
+                break;
+            }
+
+            std::wstring child = node->path + fd.cFileName;
+            const DWORD a = fd.dwFileAttributes;
+            const bool isDir = (a & FILE_ATTRIBUTE_DIRECTORY) != 0;
+
+            if (isDir && !(a & FILE_ATTRIBUTE_REPARSE_POINT))
+            {
+                node->pending.fetch_add(1);
+                EnterCriticalSection(&job.lock);
+                job.nodes.emplace_back();
+                DeleteNode* c = &job.nodes.back();
+                c->path = child + L"\\";
+                c->parent = node;
+                c->attrs = a;
+                job.queue.push_back(c);
+                LeaveCriticalSection(&job.lock);
+                WakeConditionVariable(&job.cv);
+                continue;
+            }
+
+            // File, symlink to a file, or junction (removed as a link)
+            DeleteTree_ClearAttrs(child, a);
+            BOOL ok = isDir ? RemoveDirectoryW(child.c_str()) : DeleteFileW(child.c_str());
+            if (ok)
+            {
+                job.files.fetch_add(1, std::memory_order_relaxed);
+            }
+            else
+            {
+                MoveFileExW(child.c_str(), NULL, MOVEFILE_DELAY_UNTIL_REBOOT);
+                job.failures.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        while (FindNextFileW(h, &fd));
+        FindClose(h);
+    }
+    if (!stopped) DeleteTree_Finish(job, node);
+}
+
+static DWORD WINAPI DeleteTreeWorker(LPVOID p)
+{
+    DeleteTreeJob& job = *(DeleteTreeJob*)p;
+    if (job.background) SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+
+    for (;;)
+    {
+        EnterCriticalSection(&job.lock);
+        while (job.queue.empty() && !job.done)
+        {
+            if (job.busy == 0)
+            {
+                job.done = true; // nothing queued and nobody left to queue more
+                break;
+            }
+            SleepConditionVariableCS(&job.cv, &job.lock, INFINITE);
+        }
+        if (job.Cancelled()) job.done = true;
+        if (job.done)
+        {
+            LeaveCriticalSection(&job.lock);
+            WakeAllConditionVariable(&job.cv);
+            break;
+        }
+        DeleteNode* node = job.queue.back(); // depth first keeps the queue short
+        job.queue.pop_back();
+        ++job.busy;
+        LeaveCriticalSection(&job.lock);
+
+        DeleteTree_Process(job, node);
+
+        EnterCriticalSection(&job.lock);
+        --job.busy;
+        LeaveCriticalSection(&job.lock);
+        WakeAllConditionVariable(&job.cv);
+    }
+    if (job.background) SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_END);
+    return 0;
+}
+
+// Delete a directory tree; true if the directory itself is gone. background:
+// low I/O priority and paused while a video plays (trash purge). cancel and
+// paused are the owning job's, when there is one.
+static bool DeleteDirectoryTree(const std::wstring& path, bool background = false,
+                                const std::atomic<bool>* cancel = nullptr,
+                                const std::atomic<bool>* paused = nullptr)
+{
+    const DWORD attrs = GetFileAttributesW(path.c_str());
+    if (attrs == INVALID_FILE_ATTRIBUTES) return false;
+    if (attrs & FILE_ATTRIBUTE_REPARSE_POINT)
+    {
+        DeleteTree_ClearAttrs(path, attrs);
+        return RemoveDirectoryW(path.c_str()) != FALSE;
+    }
+
+    const DWORD t0 = GetTickCount();
+    DeleteTreeJob job;
+    job.dev = IoDeviceForPath(path);
+    job.background = background;
+    job.cancel = cancel;
+    job.paused = paused;
+    job.nodes.emplace_back();
+    DeleteNode* root = &job.nodes.back();
+    root->path = EnsureSlash(path);
+    root->attrs = attrs;
+    job.queue.push_back(root);
+
+    int n = job.dev ? std::min(kDeleteMaxThreads, std::max(2, job.dev->limit * 2)) : 4;
+    std::vector<HANDLE> threads;
+    for (int i = 0; i < n; ++i)
+    {
+        HANDLE h = CreateThread(NULL, 0, DeleteTreeWorker, &job, 0, NULL);
+        if (h) threads.push_back(h);
+    }
+    if (threads.empty()) DeleteTreeWorker(&job); // no threads: do it inline
+    else WaitForMultipleObjects((DWORD)threads.size(), threads.data(), TRUE, INFINITE);
+    for (HANDLE h : threads) CloseHandle(h);
+
+    LogLine(L"DeleteTree: \"%s\" %zu file(s), %zu dir(s), %zu failure(s), %d thread(s), %lu ms",
+            path.c_str(), job.files.load(), job.dirs.load(), job.failures.load(),
+            (int)threads.size(), GetTickCount() - t0);
+    return job.rootRemoved;
+}
+
+// ----------------------------- Delete staging (.browse-trash)
+
+// Delete only renames the targets into a hidden .browse-trash folder at the
+// root of their volume, which is instant however big the tree is. A
+// background worker purges the staging folders at background I/O priority
+// and pauses while a video plays. Staging folders are listed in
+// %LOCALAPPDATA%\Browse\trash.txt, so a purge cut short by exit carries on at
+// the next start.
+
+CRITICAL_SECTION          g_trashLock;        // g_trashDirs, g_trashStaged; never held over volume I/O
+std::vector<std::wstring> g_trashDirs;        // known staging folders (with slash)
+ULONGLONG                 g_trashStaged = 0;  // bumped by every successful staging
+HANDLE                    g_trashWake = NULL; // auto-reset: something was staged
+HANDLE                    g_trashThread = NULL;
+std::atomic<ULONGLONG>    g_trashSeq{ 0 };
+
+// %LOCALAPPDATA%\Browse\<sub>, created on demand; empty on failure.
+static std::wstring AppDataDir(const wchar_t* sub)
+{
+    wchar_t base[MAX_PATH] {};
+    DWORD n = GetEnvironmentVariableW(L"LOCALAPPDATA", base, MAX_PATH);
+    if (n == 0 || n >= MAX_PATH) return std::wstring();
+    std::wstring dir = EnsureSlash(base) + L"Browse\\" + sub;
+    dir = EnsureSlash(dir);
+    int rc = SHCreateDirectoryExW(NULL, dir.c_str(), NULL);
+    if (rc != ERROR_SUCCESS && rc != ERROR_ALREADY_EXISTS && rc != ERROR_FILE_EXISTS)
+        return std::wstring();
+    return dir;
+}
+
+// Caller holds g_trashLock
+static void Trash_SaveList()
+{
+    std::wstring dir = AppDataDir(L"");
+    if (dir.empty()) return;
+    FILE* f = _wfopen((dir + L"trash.txt").c_str(), L"w, ccs=UTF-8");
+    if (!f) return;
+    for (const auto& d : g_trashDirs) fwprintf(f, L"%s\n", d.c_str());
+    fclose(f);
+}
+
+static void Trash_LoadList()
+{
+    std::wstring dir = AppDataDir(L"");
+    if (dir.empty()) return;
+    FILE* f = _wfopen((dir + L"trash.txt").c_str(), L"r, ccs=UTF-8");
+    if (!f) return;
+    wchar_t line[1024];
+    while (fgetws(line, _countof(line), f))
+    {
+        std::wstring s = Trim(line);
+        if (!s.empty()) g_trashDirs.push_back(s);
+    }
+    fclose(f);
+}
+
+static std::wstring TrashDirFor(const std::wstring& path)
+{
+    wchar_t root[MAX_PATH] {};
+    if (!GetVolumePathNameW(path.c_str(), root, MAX_PATH)) return std::wstring();
+    return EnsureSlash(root) + kTrashDirName + L"\\";
+}
+
+// Move path into its volume's staging folder. False if it cannot be renamed
+// there (in use, no rights on the volume root, ...): delete it directly then.
+static bool TrashStage(const std::wstring& path)
+{
+    std::wstring dir = TrashDirFor(path);
+    if (dir.empty() || IsDriveRoot(path)) return false;
+    if (_wcsnicmp(path.c_str(), dir.c_str(), dir.size() - 1) == 0) return false;
+
+    wchar_t name[64];
+    swprintf_s(name, L"%016llx-%llu", GetTickCount64(),
+               g_trashSeq.fetch_add(1, std::memory_order_relaxed));
+
+    // The purge may remove an empty staging folder under us: make it once more
+    bool ok = false;
+    for (int attempt = 0; attempt < 2 && !ok; ++attempt)
+    {
+        if (CreateDirectoryW(dir.c_str(), NULL))
+            SetFileAttributesW(dir.c_str(), FILE_ATTRIBUTE_HIDDEN | FILE_ATTRIBUTE_SYSTEM);
+        ok = MoveFileExW(path.c_str(), (dir + name).c_str(), 0) != FALSE;
+        if (!ok && GetLastError() != ERROR_PATH_NOT_FOUND) break;
+    }
+
+    EnterCriticalSection(&g_trashLock);
+    if (ok)
+    {
+        ++g_trashStaged;
+        bool known = false;
+        for (const auto& d : g_trashDirs) known = known || _wcsicmp(d.c_str(), dir.c_str()) == 0;
+        if (!known)
+        {
+            g_trashDirs.push_back(dir);
+            Trash_SaveList();
+        }
+    }
+    LeaveCriticalSection(&g_trashLock);
+
+    if (ok) SetEvent(g_trashWake);
+    return ok;
+}
+
+static void Trash_PurgeDir(const std::wstring& dir)
+{
+    WIN32_FIND_DATAW fd{};
+    HANDLE h = FindFirstFileExW((dir + L"*").c_str(), FindExInfoBasic, &fd,
+                                FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+    if (h != INVALID_HANDLE_VALUE)
+    {
+        do
+        {
+            if (wcscmp(fd.cFileName, L".") == 0 || wcscmp(fd.cFileName, L"..") == 0) continue;
+            while (g_govPlayback.load(std::memory_order_relaxed)) Sleep(500);
+
+            std::wstring child = dir + fd.cFileName;
+            if ((fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) &&
+                    !(fd.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT))
+            {
+                DeleteDirectoryTree(child, true);
+            }
+            else
+            {
+                ClearReadonlyAndSystem(child);
+                if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) RemoveDirectoryW(child.c_str());
+                else DeleteFileW(child.c_str());
+            }
+        }
+        while (FindNextFileW(h, &fd));
+        FindClose(h);
+    }
+
+    // Drop the staging folder once empty, unless something was staged meanwhile.
+    // It is forgotten only once removed or really gone: an unplugged disk or a
+    // dropped share keeps it listed for when the volume is back. The probes
+    // run unlocked; a staging since they began keeps the folder listed.
+    EnterCriticalSection(&g_trashLock);
+    const ULONGLONG staged = g_trashStaged;
+    LeaveCriticalSection(&g_trashLock);
+
+    std::wstring noSlash = dir.substr(0, dir.size() - 1);
+    ClearReadonlyAndSystem(noSlash);
+    bool gone = RemoveDirectoryW(noSlash.c_str()) != FALSE;
+    if (!gone && GetFileAttributesW(noSlash.c_str()) == INVALID_FILE_ATTRIBUTES)
+    {
+        const DWORD err = GetLastError();
+        const std::wstring parent = ParentDir(noSlash);
+        gone = (err == ERROR_FILE_NOT_FOUND || err == ERROR_PATH_NOT_FOUND) && !parent.empty() &&
+               GetFileAttributesW(parent.c_str()) != INVALID_FILE_ATTRIBUTES;
+        if (!gone) LogLine(L"Trash: %s unreachable (error %lu), kept for later", dir.c_str(), err);
+    }
+
+    EnterCriticalSection(&g_trashLock);
+    if (gone && g_trashStaged == staged)
+    {
+        for (size_t i = 0; i < g_trashDirs.size(); ++i)
+        {
+            if (_wcsicmp(g_trashDirs[i].c_str(), dir.c_str()) == 0)
+            {
+                g_trashDirs.erase(g_trashDirs.begin() + i);
+                break;
+            }
+        }
+        Trash_SaveList();
+    }
+    LeaveCriticalSection(&g_trashLock);
+}
+
+static DWORD WINAPI TrashPurgeProc(LPVOID)
+{
+    SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+    for (;;)
+    {
+        WaitForSingleObject(g_trashWake, INFINITE);
+
+        EnterCriticalSection(&g_trashLock);
+        std::vector<std::wstring> dirs = g_trashDirs;
+        LeaveCriticalSection(&g_trashLock);
+
+        for (const auto& d : dirs)
+        {
+            const DWORD t0 = GetTickCount();
+            Trash_PurgeDir(d);
+            LogLine(L"Trash: purged %s in %lu ms", d.c_str(), GetTickCount() - t0);
+        }
+    }
+}
+
+// At startup: resume purging whatever an earlier run left staged.
+static void Trash_Start()
+{
+    InitializeCriticalSection(&g_trashLock);
+    Trash_LoadList();
+    g_trashWake = CreateEventW(NULL, FALSE, g_trashDirs.empty() ? FALSE : TRUE, NULL);
+    g_trashThread = CreateThread(NULL, 0, TrashPurgeProc, NULL, 0, NULL);
+}
+
+// ----------------------------- XXH64 (copy verification)
+
+// Xxh64 is in xxh64.h: it needs no Win32, so it is tested on its own
+// (tests/xxh64_test.cpp).
+
+// ----------------------------- Pipelined file copy (overlapped, large buffers)
+
+// Reads and writes overlap: while block b is being written, the next blocks
+// are already being read into the other slots. Buffers are VirtualAlloc'd,
+// so they are page aligned as FILE_FLAG_NO_BUFFERING requires. Unbuffered
+// copies keep multi-GB files out of the system cache that playback relies on.
+
+static const int   kPipeSlots = 3;               // triple buffering
+static const DWORD kPipeSlotBytes = 4u << 20;    // per slot
+static const DWORD kPipeAlign = 4096;            // >= any logical sector size
+
+struct CopyBuffers
+{
+    BYTE* base = nullptr;
+    HANDLE ev[kPipeSlots] = {};
+
+    bool Ensure()
+    {
+        if (base) return true;
+        base = (BYTE*)VirtualAlloc(NULL, (SIZE_T)kPipeSlots * kPipeSlotBytes,
+                                   MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+        for (int i = 0; i < kPipeSlots && base; ++i)
+            ev[i] = CreateEventW(NULL, TRUE, FALSE, NULL);
+        return base != nullptr;
+    }
+    BYTE* Slot(int i) const { return base + (size_t)i * kPipeSlotBytes; }
+
+    ~CopyBuffers()
+    {
+        for (HANDLE h : ev) if (h) CloseHandle(h);
+        if (base) VirtualFree(base, 0, MEM_RELEASE);
+    }
+};
+
+// Open for PipelinedCopyRange (overlapped; unbuffered if asked).
+static HANDLE OpenForPipelinedCopy(const std::wstring& path, bool write, bool unbuffered)
+{
+    DWORD flags = FILE_FLAG_OVERLAPPED |
+                  (unbuffered ? FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH
+                              : FILE_FLAG_SEQUENTIAL_SCAN);
+    if (!write) flags &= ~FILE_FLAG_WRITE_THROUGH;
+    return CreateFileW(path.c_str(),
+                       write ? GENERIC_WRITE : GENERIC_READ,
+                       write ? FILE_SHARE_READ | FILE_SHARE_WRITE
+                             : FILE_SHARE_READ | FILE_SHARE_DELETE,
+                       NULL, OPEN_EXISTING, flags, NULL);
+}
+
+// Copy [offset, offset + length) from hs to hd, both opened by
+// OpenForPipelinedCopy. offset must be kPipeAlign aligned when unbuffered; the
+// final block is then written rounded up, and the caller trims the file size.
+// If hash is given, the source bytes are hashed as they are read. If slot is
+// given, a pause is honoured between blocks (see IoSlot::Checkpoint).
+// Returns 0 or a Win32 error.
+static DWORD PipelinedCopyRange(HANDLE hs, HANDLE hd, ULONGLONG offset, ULONGLONG length,
+                                bool unbuffered, CopyBuffers& bufs,
+                                std::atomic<ULONGLONG>* progress,
+                                const std::atomic<bool>* cancel, Xxh64* hash = nullptr,
+                                IoSlot* slot = nullptr)
+{
+    if (!bufs.Ensure()) return ERROR_NOT_ENOUGH_MEMORY;
+    if (length == 0) return 0;
+
+    const ULONGLONG nBlocks = (length + kPipeSlotBytes - 1) / kPipeSlotBytes;
+    OVERLAPPED ov[kPipeSlots] = {};
+    DWORD got[kPipeSlots] = {};
+    HANDLE pending[kPipeSlots] = {};   // handle with I/O in flight on the slot
+    DWORD err = 0;
+
+    auto blockLen = [&](ULONGLONG b) -> DWORD
+    {
+        return (DWORD)std::min<ULONGLONG>(kPipeSlotBytes, length - b * kPipeSlotBytes);
+    };
+    auto prep = [&](int s, ULONGLONG b)
+    {
+        ZeroMemory(&ov[s], sizeof(ov[s]));
+        ULONGLONG pos = offset + b * kPipeSlotBytes;
+        ov[s].Offset = (DWORD)pos;
+        ov[s].OffsetHigh = (DWORD)(pos >> 32);
+        ov[s].hEvent = bufs.ev[s];
+        ResetEvent(bufs.ev[s]);
+    };
+    auto issueRead = [&](ULONGLONG b) -> DWORD
+    {
+        int s = (int)(b % kPipeSlots);
+        if (!IoGovernor_Throttle(blockLen(b), cancel)) return (DWORD)ERROR_REQUEST_ABORTED;
+        prep(s, b);
+        DWORD want = blockLen(b);
+        if (unbuffered) want = (want + kPipeAlign - 1) & ~(kPipeAlign - 1);
+        if (!ReadFile(hs, bufs.Slot(s), want, NULL, &ov[s]))
+        {
+            DWORD e = GetLastError();
+            if (e != ERROR_IO_PENDING) return e;
+        }
+        pending[s] = hs;
+        return 0;
+    };
+    auto waitRead = [&](ULONGLONG b) -> DWORD
+    {
+        int s = (int)(b % kPipeSlots);
+        DWORD n = 0;
+        pending[s] = NULL;
+        if (!GetOverlappedResult(hs, &ov[s], &n, TRUE))
+        {
+            DWORD e = GetLastError();
+            if (e != ERROR_HANDLE_EOF) return e;
+        }
+        got[s] = std::min(n, blockLen(b));
+        return got[s] ? 0 : ERROR_HANDLE_EOF; // source shrank under us
+    };
+    auto issueWrite = [&](ULONGLONG b) -> DWORD
+    {
+        int s = (int)(b % kPipeSlots);
+        prep(s, b);
+        DWORD put = got[s];
+        if (unbuffered) put = (put + kPipeAlign - 1) & ~(kPipeAlign - 1);
+        if (!WriteFile(hd, bufs.Slot(s), put, NULL, &ov[s]))
+        {
+            DWORD e = GetLastError();
+            if (e != ERROR_IO_PENDING) return e;
+        }
+        pending[s] = hd;
+        return 0;
+    };
+    auto waitWrite = [&](ULONGLONG b) -> DWORD
+    {
+        int s = (int)(b % kPipeSlots);
+        if (pending[s] != hd) return 0;
+        pending[s] = NULL;
+        DWORD n = 0;
+        if (!GetOverlappedResult(hd, &ov[s], &n, TRUE)) return GetLastError();
+        if (progress) progress->fetch_add(got[s], std::memory_order_relaxed);
+        return 0;
+    };
+
+    // Prime: reads for the first kPipeSlots - 1 blocks; the last slot is
+    // refilled once the first write is under way.
+    ULONGLONG primed = std::min<ULONGLONG>(nBlocks, kPipeSlots - 1);
+    for (ULONGLONG b = 0; b < primed && !err; ++b) err = issueRead(b);
+
+    ULONGLONG readsIssued = primed;
+    for (ULONGLONG b = 0; b < nBlocks && !err; ++b)
+    {
+        // Blocks already in flight land during a pause
+        if ((cancel && cancel->load(std::memory_order_relaxed)) || (slot && !slot->Checkpoint()))
+        {
+            err = ERROR_REQUEST_ABORTED;
+            break;
+        }
+        err = waitRead(b);
+        if (!err) err = issueWrite(b);
+        // The write only reads the slot, so hashing can overlap it
+        if (!err && hash) hash->Update(bufs.Slot((int)(b % kPipeSlots)), got[b % kPipeSlots]);
+        // The slot after this one is free once its previous write landed
+        if (!err && b >= 1) err = waitWrite(b - 1);
+        while (!err && readsIssued < nBlocks && readsIssued <= b + kPipeSlots - 1)
+            err = issueRead(readsIssued++);
+    }
+    if (!err && nBlocks) err = waitWrite(nBlocks - 1);
+
+    if (err)
+    {
+        // Nothing may still target our buffers when we return
+        for (int s = 0; s < kPipeSlots; ++s)
+        {
+            if (!pending[s]) continue;
+            DWORD n = 0;
+            CancelIoEx(pending[s], &ov[s]);
+            GetOverlappedResult(pending[s], &ov[s], &n, TRUE);
+        }
+    }
+    return err;
+}
+
+// Hash [offset, offset + length) of a file, read around the system cache so
+// the bytes really come from the disk. offset must be kPipeAlign aligned.
+// If slot is given, a pause is honoured between blocks.
+static DWORD HashFileRange(const std::wstring& path, ULONGLONG offset, ULONGLONG length,
+                           CopyBuffers& bufs, const std::atomic<bool>* cancel, ULONGLONG& digest,
+                           IoSlot* slot = nullptr)
+{
+    if (!bufs.Ensure()) return ERROR_NOT_ENOUGH_MEMORY;
+    HANDLE h = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                           NULL, OPEN_EXISTING, FILE_FLAG_NO_BUFFERING | FILE_FLAG_SEQUENTIAL_SCAN,
+                           NULL);
+    if (h == INVALID_HANDLE_VALUE) return GetLastError();
+
+    Xxh64 x;
+    DWORD err = 0;
+    LARGE_INTEGER li;
+    li.QuadPart = (LONGLONG)offset;
+    if (!SetFilePointerEx(h, li, NULL, FILE_BEGIN)) err = GetLastError();
+
+    ULONGLONG left = length;
+    while (!err && left > 0)
+    {
+        if ((cancel && cancel->load(std::memory_order_relaxed)) || (slot && !slot->Checkpoint()))
+        {
+            err = ERROR_REQUEST_ABORTED;
+            break;
+        }
+        DWORD want = (DWORD)std::min<ULONGLONG>(left, kPipeSlotBytes);
+        if (!IoGovernor_Throttle(want, cancel))
+        {
+            err = ERROR_REQUEST_ABORTED;
+            break;
+        }
+        want = (want + kPipeAlign - 1) & ~(kPipeAlign - 1);
+        DWORD got = 0;
+        if (!ReadFile(h, bufs.Slot(0), want, &got, NULL))
+        {
+            err = GetLastError();
+            break;
+        }
+        got = (DWORD)std::min<ULONGLONG>(got, left);
+        if (got == 0)
+        {
+            err = ERROR_HANDLE_EOF;
+            break;
+        }
+        x.Update(bufs.Slot(0), got);
+        left -= got;
+    }
+    CloseHandle(h);
+    digest = x.Digest();
+    return err;
+}
+
+// ----------------------------- Block clone (ReFS)
+
+// On volumes with block refcounting (ReFS) a copy can share the source's
+// clusters instead of duplicating them: FSCTL_DUPLICATE_EXTENTS_TO_FILE makes
+// a same-volume copy of any size take milliseconds.
+
+static bool VolumeSupportsBlockClone(const std::wstring& path)
+{
+    wchar_t root[MAX_PATH] {};
+    DWORD flags = 0;
+    if (!GetVolumePathNameW(path.c_str(), root, MAX_PATH)) return false;
+    if (!GetVolumeInformationW(root, NULL, 0, NULL, NULL, &flags, NULL, 0)) return false;
+    return (flags & FILE_SUPPORTS_BLOCK_REFCOUNTING) != 0;
+}
+
+// Clone src into a new dst (which must not exist) on the same volume, then
+// copy the timestamp and attributes. On failure dst is removed and the
+// caller falls back to a streaming copy. Returns 0 or a Win32 error.
+static DWORD CloneFileBlocks(const std::wstring& src, const std::wstring& dst,
+                             ULONGLONG size, const FILETIME& modified, DWORD attrs)
+{
+    HANDLE hs = CreateFileW(src.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                            NULL, OPEN_EXISTING, 0, NULL);
+    if (hs == INVALID_HANDLE_VALUE) return GetLastError();
+    HANDLE hd = CreateFileW(dst.c_str(), GENERIC_READ | GENERIC_WRITE | DELETE, 0,
+                            NULL, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hd == INVALID_HANDLE_VALUE)
+    {
+        DWORD err = GetLastError();
+        CloseHandle(hs);
+        return err;
+    }
+
+    DWORD err = 0, br = 0;
+
+    // Integrity streams must match for the clone to be allowed; the buffer
+    // also tells us the cluster size clone ranges are aligned to.
+    ULONGLONG cluster = 4096;
+    FSCTL_GET_INTEGRITY_INFORMATION_BUFFER gi{};
+    if (DeviceIoControl(hs, FSCTL_GET_INTEGRITY_INFORMATION, NULL, 0, &gi, sizeof(gi), &br, NULL))
+    {
+        FSCTL_SET_INTEGRITY_INFORMATION_BUFFER si{};
+        si.ChecksumAlgorithm = gi.ChecksumAlgorithm;
+        si.Flags = gi.Flags;
+        DeviceIoControl(hd, FSCTL_SET_INTEGRITY_INFORMATION, &si, sizeof(si), NULL, 0, &br, NULL);
+        if (gi.ClusterSizeInBytes) cluster = gi.ClusterSizeInBytes;
+    }
+    if (attrs & FILE_ATTRIBUTE_SPARSE_FILE)
+        DeviceIoControl(hd, FSCTL_SET_SPARSE, NULL, 0, NULL, 0, &br, NULL);
+
+    FILE_END_OF_FILE_INFO eof;
+    eof.EndOfFile.QuadPart = (LONGLONG)size;
+    if (!SetFileInformationByHandle(hd, FileEndOfFileInfo, &eof, sizeof(eof)))
+        err = GetLastError();
+
+    // The tail range is rounded up to a whole cluster, as the FSCTL requires;
+    // a single call must stay below 4 GB.
+    const ULONGLONG kStep = 1ull << 30;
+    const ULONGLONG end = (size + cluster - 1) / cluster * cluster;
+    for (ULONGLONG off = 0; !err && off < end; off += kStep)
+    {
+        DUPLICATE_EXTENTS_DATA dx{};
+        dx.FileHandle = hs;
+        dx.SourceFileOffset.QuadPart = (LONGLONG)off;
+        dx.TargetFileOffset.QuadPart = (LONGLONG)off;
+        dx.ByteCount.QuadPart = (LONGLONG)std::min(kStep, end - off);
+        if (!DeviceIoControl(hd, FSCTL_DUPLICATE_EXTENTS_TO_FILE, &dx, sizeof(dx),
+                             NULL, 0, &br, NULL))
+        {
+            err = GetLastError();
+        }
+    }
+
+    if (!err) SetFileTime(hd, NULL, NULL, &modified);
+    if (err)
+    {
+        FILE_DISPOSITION_INFO del{ TRUE };
+        SetFileInformationByHandle(hd, FileDispositionInfo, &del, sizeof(del));
+    }
+    CloseHandle(hd);
+    CloseHandle(hs);
+
+    if (!err && (attrs & ~FILE_ATTRIBUTE_NORMAL & ~FILE_ATTRIBUTE_ARCHIVE))
+        SetFileAttributesW(dst.c_str(), attrs);
+    return err;
+}
+
+// ----------------------------- Copy job journal
+
+// Every paste records its progress under %LOCALAPPDATA%\Browse\jobs, in a
+// file named after the mode, the destination folder and the clipboard
+// entries. The journal holds the destination picked for each entry, each
+// finished file and each finished chunk of a big file (written to
+// <dst>.partial until its last chunk lands). If the same entries
+// are pasted into the same folder again after a cancel or a crash, the journal
+// is found and finished work is skipped. One tab-separated record per line:
+//   item   <entry> <dst>
+//   done   <size> <mtime> <hash|-> <dst>
+//   chunk  <offset> <size> <mtime> <dst>
+
+static const int kJournalMaxAgeDays = 30;
+
+struct JournalFile
+{
+    ULONGLONG size = 0, mtime = 0;
+    std::wstring hash;                   // "-" when not hashed
+};
+
+struct CopyJournal
+{
+    std::wstring path;
+    FILE* f = nullptr;
+    CRITICAL_SECTION lock;
+
+    // Loaded from a previous run (keys are lower-case destination paths)
+    std::map<size_t, std::wstring> itemDst;
+    std::map<std::wstring, JournalFile> done;
+    std::map<std::wstring, std::vector<ULONGLONG>> chunks;  // finished chunk offsets
+    std::map<std::wstring, JournalFile> chunkSource;        // source state the chunks are from
+
+    CopyJournal() { InitializeCriticalSection(&lock); }
+    ~CopyJournal()
+    {
+        if (f) fclose(f);
+        DeleteCriticalSection(&lock);
+    }
+
+    bool Active() const { return f != nullptr; }
+
+    void Append(const wchar_t* fmt, ...)
+    {
+        if (!f) return;
+        wchar_t buf[2048];
+        va_list ap;
+        va_start(ap, fmt);
+        _vsnwprintf_s(buf, _countof(buf), _TRUNCATE, fmt, ap);
+        va_end(ap);
+        EnterCriticalSection(&lock);
+        fwprintf(f, L"%s\n", buf);
+        fflush(f);
+        LeaveCriticalSection(&lock);
+    }
+};
+
+static ULONGLONG FileTimeU64(const FILETIME& ft)
+{
+    return ((ULONGLONG)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+}
+
+static std::wstring JobJournalDir()
+{
+    return AppDataDir(L"jobs");
+}
+
+// Files in dir nobody came back to (journals, stored listings)
+static void PurgeOldFiles(const std::wstring& dir, const wchar_t* pattern, int maxAgeDays)
+{
+    FILETIME now;
+    GetSystemTimeAsFileTime(&now);
+    const ULONGLONG maxAge = (ULONGLONG)maxAgeDays * 24 * 3600 * 10000000ULL;
+
+    WIN32_FIND_DATAW fd{};
+    HANDLE h = FindFirstFileW((dir + pattern).c_str(), &fd);
+    if (h == INVALID_HANDLE_VALUE) return;
+    do
+    {
+        if (FileTimeU64(now) - FileTimeU64(fd.ftLastWriteTime) > maxAge)
+            DeleteFileW((dir + fd.cFileName).c_str());
+    }
+    while (FindNextFileW(h, &fd));
+    FindClose(h);
+}
+
+static std::vector<std::wstring> SplitTabs(const std::wstring& s)
+{
+    std::vector<std::wstring> out;
+    size_t start = 0;
+    for (;;)
+    {
+        size_t tab = s.find(L'\t', start);
+        out.push_back(s.substr(start, tab == std::wstring::npos ? std::wstring::npos : tab - start));
+        if (tab == std::wstring::npos) break;
+        start = tab + 1;
+    }
+    return out;
+}
+
+// Find the journal for this paste. Returns true when an unfinished earlier
+// run left one behind; its records are loaded into j.
+static bool CopyJournal_Load(CopyJournal& j, bool isCopy, const std::wstring& dstFolder,
+                             const std::vector<std::wstring>& srcs)
+{
+    std::wstring dir = JobJournalDir();
+    if (dir.empty()) return false;
+    PurgeOldFiles(dir, L"*.journal", kJournalMaxAgeDays);
+
+    // FNV-1a over everything that identifies the job
+    ULONGLONG key = 1469598103934665603ULL;
+    auto mix = [&key](const std::wstring& s)
+    {
+        for (wchar_t c : ToLower(s) + L'\n')
+        {
+            key ^= (ULONGLONG)c;
+            key *= 1099511628211ULL;
+        }
+    };
+    mix(isCopy ? L"copy" : L"move");
+    mix(EnsureSlash(dstFolder));
+    for (const auto& s : srcs) mix(s);
+
+    wchar_t name[40];
+    swprintf_s(name, L"%016llx.journal", key);
+    j.path = dir + name;
+
+    FILE* in = _wfopen(j.path.c_str(), L"r, ccs=UTF-8");
+    if (!in) return false;
+
+    bool any = false;
+    wchar_t line[4096];
+    while (fgetws(line, _countof(line), in))
+    {
+        std::wstring s = line;
+        while (!s.empty() && (s.back() == L'\n' || s.back() == L'\r')) s.pop_back();
+        std::vector<std::wstring> v = SplitTabs(s);
+
+        if (v[0] == L"item" && v.size() == 3)
+        {
+            j.itemDst[(size_t)_wtoi(v[1].c_str())] = v[2];
+            any = true;
+        }
+        else if (v[0] == L"done" && v.size() == 5)
+        {
+            JournalFile jf;
+            jf.size = _wcstoui64(v[1].c_str(), NULL, 10);
+            jf.mtime = _wcstoui64(v[2].c_str(), NULL, 10);
+            jf.hash = v[3];
+            j.done[ToLower(v[4])] = jf;
+        }
+        else if (v[0] == L"chunk" && v.size() == 5)
+        {
+            JournalFile jf;
+            jf.size = _wcstoui64(v[2].c_str(), NULL, 10);
+            jf.mtime = _wcstoui64(v[3].c_str(), NULL, 10);
+            std::wstring k = ToLower(v[4]);
+            j.chunks[k].push_back(_wcstoui64(v[1].c_str(), NULL, 10));
+            j.chunkSource[k] = jf;
+        }
+    }
+    fclose(in);
+    return any;
+}
+
+// Start recording. Without resume, earlier records are dropped.
+static void CopyJournal_Start(CopyJournal& j, bool resume, bool isCopy,
+                              const std::wstring& dstFolder, const std::vector<std::wstring>& srcs)
+{
+    if (j.path.empty()) return;
+    if (!resume)
+    {
+        j.itemDst.clear();
+        j.done.clear();
+        j.chunks.clear();
+        j.chunkSource.clear();
+    }
+    j.f = _wfopen(j.path.c_str(), resume ? L"a, ccs=UTF-8" : L"w, ccs=UTF-8");
+    if (!j.f || resume) return;
+    j.Append(L"browse-job\t1\t%s\t%s", isCopy ? L"copy" : L"move", dstFolder.c_str());
+    for (const auto& s : srcs) j.Append(L"src\t%s", s.c_str());
+}
+
+// Close; the file is kept only when there is something left to resume.
+static void CopyJournal_Finish(CopyJournal& j, bool keep)
+{
+    if (j.f)
+    {
+        fclose(j.f);
+        j.f = nullptr;
+    }
+    if (!keep && !j.path.empty()) DeleteFileW(j.path.c_str());
+}
+
+// ----------------------------- Network listing cache
+//
+// Listings of folders on network shares are also kept on disk under
+// %LOCALAPPDATA%\Browse\netcache, one file per folder, so even the first
+// visit in a session shows at once. A stored listing younger than its
+// share's TTL (netCacheTtl in browse.ini) is shown as it is; an older one is
+// shown too and revalidated in the background by listing the folder again.
+// Only a listing made in full within kNavStampTrustMs may be confirmed by the
+// folder's last-write time alone, which misses files that grow in place.
+// One tab-separated record per line:
+//   browse-netcache  1  <folder>  <folder mtime>  <saved>
+//   <name>  <d|f>  <size>  <mtime>  <width>  <height>  <duration>
+
+static const int kNetCacheMaxAgeDays = 30;
+
+static std::wstring NetCache_File(const std::wstring& folder)
+{
+    std::wstring dir = AppDataDir(L"netcache");
+    if (dir.empty()) return dir;
+    static bool purged = false;
+    if (!purged) PurgeOldFiles(dir, L"*.list", kNetCacheMaxAgeDays);
+    purged = true;
+
+    ULONGLONG key = 1469598103934665603ULL;   // FNV-1a
+    for (wchar_t c : ToLower(EnsureSlash(folder)))
+    {
+        key ^= (ULONGLONG)c;
+        key *= 1099511628211ULL;
+    }
+    wchar_t name[40];
+    swprintf_s(name, L"%016llx.list", key);
+    return dir + name;
+}
+
+// Seconds a stored listing of folder is trusted; negative: not stored at all
+static int NetCache_Ttl(const std::wstring& folder)
+{
+    std::wstring share = folder.substr(0, 2);  // "x:"
+    if (folder.compare(0, 2, L"\\\\") == 0)
+    {
+        size_t server = folder.find(L'\\', 2);
+        size_t end = server == std::wstring::npos ? server : folder.find(L'\\', server + 1);
+        share = folder.substr(0, end);
+    }
+    auto it = g_cfg.netCacheTtlShare.find(ToLower(share));
+    return it != g_cfg.netCacheTtlShare.end() ? it->second : g_cfg.netCacheTtl;
+}
+
+// Stored listings are written by one background thread. NetCache_Store hands
+// it a listing only when it differs from the one last written or loaded;
+// otherwise the stored file is just marked fresh (its last-write time is the
+// listing's age).
+struct NetCacheWrite
+{
+    enum Kind { Write, Touch, Drop } kind = Write;
+    std::wstring folder;
+    std::vector<Row> rows;
+    FILETIME stamp{};
+};
+
+static CRITICAL_SECTION g_netCacheLock;
+static std::map<std::wstring, NetCacheWrite> g_netCacheQueue;   // lower-case folder -> newest
+static HANDLE g_netCacheWake = NULL;
+static std::unordered_map<std::wstring, ULONGLONG> g_netCacheSig; // UI thread: folder -> listing hash
+
+// Hash of a listing in any row order (shown sorted, prefetched as listed)
+static ULONGLONG NetCache_Sig(const std::vector<Row>& rows, const FILETIME& stamp)
+{
+    ULONGLONG sum = FileTimeU64(stamp);
+    for (const auto& r : rows)
+    {
+        ULONGLONG h = 1469598103934665603ULL;   // FNV-1a per row
+        auto mix = [&h](ULONGLONG v)
+        {
+            h ^= v;
+            h *= 1099511628211ULL;
+        };
+        for (wchar_t c : r.name) mix(c);
+        mix(r.isDir);
+        mix(r.size);
+        mix(FileTimeU64(r.modified));
+        mix(((ULONGLONG)(unsigned)r.vW << 32) | (unsigned)r.vH);
+        mix(r.vDur100ns);
+        sum += h;
+    }
+    return sum;
+}
+
+static void NetCache_Write(const NetCacheWrite& w)
+{
+    const std::wstring path = NetCache_File(w.folder);
+    if (path.empty()) return;
+    if (w.kind == NetCacheWrite::Drop)
+    {
+        DeleteFileW(path.c_str());
+        return;
+    }
+
+    FILETIME now;
+    GetSystemTimeAsFileTime(&now);
+    if (w.kind == NetCacheWrite::Touch)
+    {
+        HANDLE h = CreateFileW(path.c_str(), FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ, NULL,
+                               OPEN_EXISTING, 0, NULL);
+        if (h == INVALID_HANDLE_VALUE) return;
+        SetFileTime(h, NULL, NULL, &now);
+        CloseHandle(h);
+        return;
+    }
+
+    const std::wstring tmp = path + L".tmp";
+    FILE* f = _wfopen(tmp.c_str(), L"w, ccs=UTF-8");
+    if (!f) return;
+    fwprintf(f, L"browse-netcache\t1\t%s\t%llu\t%llu\n", EnsureSlash(w.folder).c_str(),
+             FileTimeU64(w.stamp), FileTimeU64(now));
+    for (const auto& r : w.rows)
+        fwprintf(f, L"%s\t%c\t%llu\t%llu\t%d\t%d\t%llu\n", r.name.c_str(), r.isDir ? L'd' : L'f',
+                 r.size, FileTimeU64(r.modified), r.vW, r.vH, r.vDur100ns);
+    const bool ok = !ferror(f);
+    fclose(f);
+    if (!ok || !MoveFileExW(tmp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING))
+        DeleteFileW(tmp.c_str());
+}
+
+static DWORD WINAPI NetCacheWriterProc(LPVOID)
+{
+    SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+    for (;;)
+    {
+        WaitForSingleObject(g_netCacheWake, INFINITE);
+        for (;;)
+        {
+            EnterCriticalSection(&g_netCacheLock);
+            if (g_netCacheQueue.empty())
+            {
+                LeaveCriticalSection(&g_netCacheLock);
+                break;
+            }
+            NetCacheWrite w = std::move(g_netCacheQueue.begin()->second);
+            g_netCacheQueue.erase(g_netCacheQueue.begin());
+            LeaveCriticalSection(&g_netCacheLock);
+            NetCache_Write(w);
+        }
+    }
+}
+
+static void NetCache_Queue(NetCacheWrite w)
+{
+    if (!g_netCacheWake)
+    {
+        InitializeCriticalSection(&g_netCacheLock);
+        g_netCacheWake = CreateEventW(NULL, FALSE, FALSE, NULL);
+        HANDLE h = CreateThread(NULL, 0, NetCacheWriterProc, NULL, 0, NULL);
+        if (h) CloseHandle(h);
+    }
+    const std::wstring key = ToLower(EnsureSlash(w.folder));
+    EnterCriticalSection(&g_netCacheLock);
+    auto it = g_netCacheQueue.find(key);
+    // A touch does not undo a write still waiting
+    if (!(w.kind == NetCacheWrite::Touch && it != g_netCacheQueue.end()))
+        g_netCacheQueue[key] = std::move(w);
+    LeaveCriticalSection(&g_netCacheLock);
+    SetEvent(g_netCacheWake);
+}
+
+// rows is the folder's listing as of now
+static void NetCache_Store(const std::wstring& folder, const std::vector<Row>& rows,
+                           const FILETIME& stamp)
+{
+    if (NetCache_Ttl(folder) < 0) return;
+    const std::wstring key = ToLower(EnsureSlash(folder));
+    const ULONGLONG sig = NetCache_Sig(rows, stamp);
+    auto known = g_netCacheSig.find(key);
+
+    NetCacheWrite w;
+    w.folder = folder;
+    if (known != g_netCacheSig.end() && known->second == sig)
+    {
+        w.kind = NetCacheWrite::Touch;
+    }
+    else
+    {
+        w.rows = rows;
+        w.stamp = stamp;
+        g_netCacheSig[key] = sig;
+    }
+    NetCache_Queue(std::move(w));
+}
+
+// The folder could not be listed: its stored listing is no longer true
+static void NetCache_Drop(const std::wstring& folder)
+{
+    g_netCacheSig.erase(ToLower(EnsureSlash(folder)));
+    NetCacheWrite w;
+    w.kind = NetCacheWrite::Drop;
+    w.folder = folder;
+    NetCache_Queue(std::move(w));
+}
+
+static FILETIME U64FileTime(ULONGLONG v)
+{
+    FILETIME ft;
+    ft.dwLowDateTime = (DWORD)v;
+    ft.dwHighDateTime = (DWORD)(v >> 32);
+    return ft;
+}
+
+// The stored listing of folder and its age in seconds; false if there is none
+static bool NetCache_Load(const std::wstring& folder, std::vector<Row>& rows,
+                          FILETIME& stamp, ULONGLONG& ageSec)
+{
+    const std::wstring path = NetCache_File(folder);
+    if (path.empty()) return false;
+    FILE* f = _wfopen(path.c_str(), L"r, ccs=UTF-8");
+    if (!f) return false;
+
+    wchar_t buf[2048];
+    auto readLine = [&](std::wstring& line) -> bool
+    {
+        if (!fgetws(buf, _countof(buf), f)) return false;
+        line = buf;
+        while (!line.empty() && (line.back() == L'\n' || line.back() == L'\r')) line.pop_back();
+        return true;
+    };
+
+    const std::wstring dir = EnsureSlash(folder);
+    std::wstring line;
+    bool ok = false;
+    if (readLine(line))
+    {
+        std::vector<std::wstring> h = SplitTabs(line);
+        ok = h.size() >= 5 && h[0] == L"browse-netcache" && h[1] == L"1" &&
+             _wcsicmp(h[2].c_str(), dir.c_str()) == 0;
+        if (ok)
+        {
+            stamp = U64FileTime(_wcstoui64(h[3].c_str(), NULL, 10));
+            // Marked fresh by touching the file: its last-write time, not the header, is when
+            ULONGLONG saved = _wcstoui64(h[4].c_str(), NULL, 10);
+            WIN32_FILE_ATTRIBUTE_DATA fad{};
+            if (GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &fad))
+                saved = std::max(saved, FileTimeU64(fad.ftLastWriteTime));
+            FILETIME now;
+            GetSystemTimeAsFileTime(&now);
+            ageSec = FileTimeU64(now) > saved ? (FileTimeU64(now) - saved) / 10000000ULL : 0;
+        }
+    }
+    while (ok && readLine(line))
+    {
+        std::vector<std::wstring> t = SplitTabs(line);
+        if (t.size() < 7 || t[0].empty()) continue;
+        Row r;
+        r.name = t[0];
+        r.full = dir + t[0];
+        r.isDir = (t[1] == L"d");
+        r.size = _wcstoui64(t[2].c_str(), NULL, 10);
+        r.modified = U64FileTime(_wcstoui64(t[3].c_str(), NULL, 10));
+        r.vW = _wtoi(t[4].c_str());
+        r.vH = _wtoi(t[5].c_str());
+        r.vDur100ns = _wcstoui64(t[6].c_str(), NULL, 10);
+        rows.push_back(std::move(r));
+    }
+    fclose(f);
+    return ok;
+}
+
+// Show a network folder from its stored listing; false if there is none
+static bool NetCache_Show(std::wstring abs)
+{
+    if (abs.size() == 2 && abs[1] == L':') abs += L'\\';
+    abs = EnsureSlash(abs);
+    if (!IsNetworkFolder(abs)) return false;
+    const int ttl = NetCache_Ttl(abs);
+    if (ttl < 0) return false;
+
+    NavEntry e;
+    ULONGLONG age = 0;
+    if (!NetCache_Load(abs, e.rows, e.stamp, age)) return false;
+    g_netCacheSig[ToLower(abs)] = NetCache_Sig(e.rows, e.stamp);
+    e.folder = abs;
+    e.sortCol = -1; // sorted when shown
+    const ULONGLONG now = GetTickCount64();
+    e.fullTick = now - std::min(now, age * 1000);
+
+    const bool stale = age > (ULONGLONG)ttl;
+    LogLine(L"NetCache: \"%s\" from disk, %zu entries, %llus old (ttl %ds)%s", abs.c_str(),
+            e.rows.size(), age, ttl, stale ? L", revalidating" : L"");
+    NavCache_Display(e, stale);
+    return true;
+}
+
+// ----------------------------- Copy engine (parallel paste)
+
+// A paste is planned up front: every source tree is scanned, every destination
+// decided and the directory skeleton created. Files are then copied by a small
+// pool of worker threads (browse.ini copyStreams). Small files are handed out
+// in batches so per-file round trips on SMB overlap across streams; big files
+// are split into chunks so several streams work on one file.
+
+static const ULONGLONG kCopySmallFileMax = 1ull << 20;    // batched below this
+static const size_t    kCopyBatchFiles = 64;
+static const ULONGLONG kCopyBatchBytes = 16ull << 20;
+static const ULONGLONG kCopyChunkedMin = 256ull << 20;    // chunked at/above this
+static const ULONGLONG kCopyChunkBytes = 64ull << 20;
+
+// Chunked files are written under this name and renamed when the last chunk
+// lands, so a cancelled or failed copy never looks like a finished one.
+static std::wstring PartialCopyPath(const std::wstring& dst)
+{
+    return dst + L".partial";
+}
+
+struct CopyFileEntry
+{
+    std::wstring src, dst;
+    ULONGLONG size = 0;
+    FILETIME  modified{};
+    DWORD     attrs = 0;
+    int       item = 0;        // clipboard entry this file belongs to
+    int       chunksLeft = 0;  // chunked files: finished when this reaches 0
+    bool      created = false; // chunked files: pre-created by the skeleton
+    ULONGLONG startTick = 0;   // chunked files: when the first chunk started
+    bool      skip = false;    // finished by an earlier run (journal)
+    bool      resumed = false; // chunked: partial copy from an earlier run exists
+    std::vector<ULONGLONG> doneChunks; // resumed: chunk offsets already copied
+    std::vector<ULONGLONG> chunkHashes; // verify: XXH64 per chunk
+    bool      exclusive = false; // pasted file whose name came from the resolver:
+                                 // create it exclusively, re-resolve on a race
+    bool      failed = false;
+};
+
+struct CopyTask
+{
+    enum Kind { Batch, Whole, Chunk, Clone } kind = Whole;
+    size_t first = 0, count = 0;    // Batch: range in CopyJob::smallOrder
+    size_t file = 0;                // Whole / Chunk / Clone
+    ULONGLONG offset = 0, length = 0;
+};
+
+struct CopyItemState
+{
+    std::wstring src, dst;
+    std::wstring nameBase, nameExt; // to re-resolve dst if its name is taken meanwhile
+    bool isDir = false;
+    bool clone = false;     // same block-cloning volume: files are cloned
+    bool failed = false;
+    IoDevice* srcDev = nullptr;   // scheduler slots every task takes
+    IoDevice* dstDev = nullptr;
+    DWORD error = 0;
+};
+
+struct CopyJob
+{
+    std::vector<std::pair<std::wstring, int>> dirs;   // (destination dir, item), parents first
+    std::vector<std::wstring> srcDirs;                // source of each dirs entry
+    std::vector<CopyFileEntry> files;
+    std::vector<size_t> smallOrder;
+    std::vector<CopyTask> tasks;
+    std::vector<CopyItemState> items;
+    ULONGLONG totalBytes = 0;
+
+    CRITICAL_SECTION lock;           // nextTask, CopyFileEntry::chunksLeft/failed/startTick, items
+    size_t nextTask = 0;
+    std::atomic<ULONGLONG> bytesDone{ 0 };
+    std::atomic<size_t> filesDone{ 0 };
+    const std::atomic<bool>* cancel = nullptr;
+    TransferStats stats;
+    CopyJournal* journal = nullptr;
+    bool verify = false;             // hash source while copying, re-read and compare
+    NameResolver* names = nullptr;   // destination names of this paste
+    bool move = false;               // cross-volume move: sources go file by file
+    Job* owner = nullptr;            // pause requests
+
+    CopyJob() { InitializeCriticalSection(&lock); }
+    ~CopyJob() { DeleteCriticalSection(&lock); }
+
+    bool Cancelled() const
+    {
+        return cancel && cancel->load(std::memory_order_relaxed);
+    }
+
+    void Fail(size_t file, DWORD err)
+    {
+        EnterCriticalSection(&lock);
+        CopyFileEntry& f = files[file];
+        f.failed = true;
+        CopyItemState& it = items[f.item];
+        if (!it.failed || !it.error) it.error = err;
+        it.failed = true;
+        LeaveCriticalSection(&lock);
+    }
+};
+
+static void CopyJob_AddFile(CopyJob& job, const std::wstring& src, const std::wstring& dst,
+                            ULONGLONG size, const FILETIME& modified, DWORD attrs, int item)
+{
+    CopyFileEntry f;
+    f.src = src;
+    f.dst = dst;
+    f.size = size;
+    f.modified = modified;
+    f.attrs = attrs;
+    f.item = item;
+    job.files.push_back(std::move(f));
+    job.totalBytes += size;
+}
+
+// Pre-scan one source directory into the plan (runs on the job thread).
+static void CopyJob_ScanDir(CopyJob& job, const std::wstring& srcDirIn,
+                            const std::wstring& dstDirIn, int item)
+{
+    std::wstring srcDir = EnsureSlash(srcDirIn);
+    std::wstring dstDir = EnsureSlash(dstDirIn);
+    job.dirs.push_back(std::make_pair(dstDir, item));
+    job.srcDirs.push_back(srcDir);
+
+    WIN32_FIND_DATAW fd{};
+    HANDLE h = FindFirstFileExW((srcDir + L"*").c_str(), FindExInfoBasic, &fd,
+                                FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+    if (h == INVALID_HANDLE_VALUE) return;
+
+    do
+    {
+        if (wcscmp(fd.cFileName, L".") == 0 || wcscmp(fd.cFileName, L"..") == 0) continue;
+        if (job.Cancelled()) break;
+
+        bool isDir = (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+        bool isReparse = (fd.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0;
+
+        if (isDir && !isReparse)
+        {
+            CopyJob_ScanDir(job, srcDir + fd.cFileName, dstDir + fd.cFileName, item);
+        }
+        else
+        {
+            ULARGE_INTEGER uli;
+            uli.HighPart = fd.nFileSizeHigh;
+            uli.LowPart = fd.nFileSizeLow;
+            CopyJob_AddFile(job, srcDir + fd.cFileName, dstDir + fd.cFileName,
+                            uli.QuadPart, fd.ftLastWriteTime, fd.dwFileAttributes, item);
+        }
+    }
+    while (FindNextFileW(h, &fd));
+    FindClose(h);
+}
+
+// Resume: skip files an earlier run finished and chunks it already copied,
+// as long as neither the source nor the copy changed since.
+static void CopyJob_ApplyJournal(CopyJob& job, const CopyJournal& j)
+{
+    size_t skipped = 0, resumed = 0;
+    for (auto& f : job.files)
+    {
+        const ULONGLONG mtime = FileTimeU64(f.modified);
+        const std::wstring key = ToLower(f.dst);
+        WIN32_FILE_ATTRIBUTE_DATA fad{};
+        auto sizeOf = [&fad]() { return ((ULONGLONG)fad.nFileSizeHigh << 32) | fad.nFileSizeLow; };
+
+        auto d = j.done.find(key);
+        if (d != j.done.end())
+        {
+            if (GetFileAttributesExW(f.dst.c_str(), GetFileExInfoStandard, &fad) &&
+                    d->second.size == f.size && d->second.mtime == mtime && sizeOf() == f.size &&
+                    FileTimeU64(fad.ftLastWriteTime) == mtime)
+            {
+                f.skip = true;
+                ++skipped;
+            }
+            continue;
+        }
+
+        // Unfinished chunked copies are still under their .partial name
+        auto c = j.chunks.find(key);
+        if (c == j.chunks.end() || f.size < kCopyChunkedMin) continue;
+        if (!GetFileAttributesExW(PartialCopyPath(f.dst).c_str(), GetFileExInfoStandard, &fad) ||
+                sizeOf() != f.size) continue;
+        const JournalFile& src = j.chunkSource.at(key);
+        if (src.size != f.size || src.mtime != mtime) continue;
+        f.resumed = true;
+        f.created = true;
+        f.doneChunks = c->second;
+        ++resumed;
+    }
+    LogLine(L"Paste: resuming from %s, %zu file(s) already done, %zu partial",
+            j.path.c_str(), skipped, resumed);
+}
+
+// Move: get the copy onto the disk and make sure it is whole before the
+// source goes. Returns 0 or a Win32 error.
+static DWORD CopyJob_FlushCopy(const CopyFileEntry& f)
+{
+    if (f.attrs & FILE_ATTRIBUTE_DIRECTORY) return 0; // link copied as a link
+
+    const bool readOnly = (f.attrs & FILE_ATTRIBUTE_READONLY) != 0;
+    if (readOnly) SetFileAttributesW(f.dst.c_str(), f.attrs & ~FILE_ATTRIBUTE_READONLY);
+
+    DWORD err = 0;
+    HANDLE h = CreateFileW(f.dst.c_str(), GENERIC_WRITE,
+                           FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                           NULL, OPEN_EXISTING, 0, NULL);
+    if (h == INVALID_HANDLE_VALUE)
+    {
+        err = GetLastError();
+    }
+    else
+    {
+        LARGE_INTEGER size{};
+        if (!FlushFileBuffers(h)) err = GetLastError();
+        else if (!GetFileSizeEx(h, &size) || (ULONGLONG)size.QuadPart != f.size) err = ERROR_FILE_INVALID;
+        CloseHandle(h);
+    }
+
+    if (readOnly) SetFileAttributesW(f.dst.c_str(), f.attrs);
+    return err;
+}
+
+// Move: remove one source file whose copy is safe
+static void CopyJob_DropSource(CopyJob& job, size_t i)
+{
+    const CopyFileEntry& f = job.files[i];
+    ClearReadonlyAndSystem(f.src);
+    BOOL ok = (f.attrs & FILE_ATTRIBUTE_DIRECTORY) ? RemoveDirectoryW(f.src.c_str())
+                                                   : DeleteFileW(f.src.c_str());
+    if (!ok)
+    {
+        DWORD err = GetLastError();
+        LogLine(L"Move: could not remove source \"%s\" (error %lu)", f.src.c_str(), err);
+        job.Fail(i, err);
+    }
+}
+
+// A file's copy is complete. A move flushes and checks the copy, journals it
+// and only then removes the source, so a crash at any point leaves either
+// both files or a durable copy: the source space is freed as the move goes.
+static void CopyJob_FileDone(CopyJob& job, size_t i, const ULONGLONG* hash = nullptr)
+{
+    const CopyFileEntry& f = job.files[i];
+    if (job.move)
+    {
+        DWORD err = CopyJob_FlushCopy(f);
+        if (err)
+        {
+            job.Fail(i, err);
+            return;
+        }
+    }
+    if (job.journal)
+    {
+        wchar_t hex[20] = L"-";
+        if (hash) swprintf_s(hex, L"%016llx", *hash);
+        job.journal->Append(L"done\t%llu\t%llu\t%s\t%s",
+                            f.size, FileTimeU64(f.modified), hex, f.dst.c_str());
+    }
+    if (job.move) CopyJob_DropSource(job, i);
+}
+
+// Split the plan into worker tasks: chunks of big files first, then whole
+// files largest first, then batches of small files.
+static void CopyJob_PlanTasks(CopyJob& job)
+{
+    std::vector<size_t> whole;
+    for (size_t i = 0; i < job.files.size(); ++i)
+    {
+        CopyFileEntry& f = job.files[i];
+        if (f.skip)
+        {
+            // A move that crashed between journaling a copy and removing its source
+            if (job.move) CopyJob_DropSource(job, i);
+            job.bytesDone.fetch_add(f.size, std::memory_order_relaxed);
+            job.filesDone.fetch_add(1, std::memory_order_relaxed);
+        }
+        else if (job.items[f.item].clone && f.size >= kCopySmallFileMax)
+        {
+            CopyTask t;
+            t.kind = CopyTask::Clone;
+            t.file = i;
+            job.tasks.push_back(t);
+        }
+        else if (f.size >= kCopyChunkedMin)
+        {
+            // A resumed file keeps at least its tail chunk, whose completion
+            // finishes the file.
+            auto copied = [&f](ULONGLONG off)
+            {
+                return off + kCopyChunkBytes < f.size &&
+                       std::find(f.doneChunks.begin(), f.doneChunks.end(), off) != f.doneChunks.end();
+            };
+            if (job.verify) f.chunkHashes.assign((size_t)((f.size + kCopyChunkBytes - 1) / kCopyChunkBytes), 0);
+            for (ULONGLONG off = 0; off < f.size; off += kCopyChunkBytes)
+            {
+                if (copied(off))
+                {
+                    job.bytesDone.fetch_add(kCopyChunkBytes, std::memory_order_relaxed);
+                    continue;
+                }
+                CopyTask t;
+                t.kind = CopyTask::Chunk;
+                t.file = i;
+                t.offset = off;
+                t.length = std::min(kCopyChunkBytes, f.size - off);
+                job.tasks.push_back(t);
+                ++f.chunksLeft;
+            }
+        }
+        else if (f.size >= kCopySmallFileMax)
+        {
+            whole.push_back(i);
+        }
+        else
+        {
+            job.smallOrder.push_back(i);
+        }
+    }
+
+    std::sort(whole.begin(), whole.end(), [&job](size_t a, size_t b)
+    {
+        return job.files[a].size > job.files[b].size;
+    });
+    for (size_t i : whole)
+    {
+        CopyTask t;
+        t.kind = CopyTask::Whole;
+        t.file = i;
+        job.tasks.push_back(t);
+    }
+
+    // A batch runs under one IoSlot, so all its files share their devices
+    auto devicesDiffer = [&job](size_t a, size_t b)
+    {
+        const CopyItemState& x = job.items[job.files[job.smallOrder[a]].item];
+        const CopyItemState& y = job.items[job.files[job.smallOrder[b]].item];
+        return x.srcDev != y.srcDev || x.dstDev != y.dstDev;
+    };
+    size_t start = 0;
+    ULONGLONG bytes = 0;
+    for (size_t k = 0; k <= job.smallOrder.size(); ++k)
+    {
+        bool flush = (k == job.smallOrder.size()) ||
+                     (k - start >= kCopyBatchFiles) || (bytes >= kCopyBatchBytes) ||
+                     (k > start && devicesDiffer(start, k));
+        if (flush && k > start)
+        {
+            CopyTask t;
+            t.kind = CopyTask::Batch;
+            t.first = start;
+            t.count = k - start;
+            job.tasks.push_back(t);
+            start = k;
+            bytes = 0;
+        }
+        if (k < job.smallOrder.size()) bytes += job.files[job.smallOrder[k]].size;
+    }
+}
+
+// A pasted file's resolved name was created by someone else after the
+// destination was listed: claim the next free name and copy there instead.
+static bool CopyJob_Reclaim(CopyJob& job, size_t i)
+{
+    EnterCriticalSection(&job.lock);
+    CopyFileEntry& f = job.files[i];
+    CopyItemState& it = job.items[f.item];
+    bool ok = false;
+    if (f.exclusive && job.names)
+    {
+        std::wstring dst = job.names->Claim(it.nameBase, it.nameExt, false);
+        LogLine(L"Paste: \"%s\" appeared meanwhile, using \"%s\"", f.dst.c_str(), dst.c_str());
+        ok = (dst != f.dst);
+        f.dst = it.dst = dst;
+        if (job.journal) job.journal->Append(L"item\t%d\t%s", f.item, dst.c_str());
+    }
+    f.exclusive = false;
+    LeaveCriticalSection(&job.lock);
+    return ok;
+}
+
+// Create destination directories, and pre-size chunked files so every
+// stream can write its range. Items whose skeleton fails are marked failed.
+static void CopyJob_MakeSkeleton(CopyJob& job)
+{
+    for (const auto& d : job.dirs)
+    {
+        if (job.items[d.second].failed) continue;
+        if (!CreateDirectoryW(d.first.c_str(), NULL) && GetLastError() != ERROR_ALREADY_EXISTS)
+        {
+            job.items[d.second].failed = true;
+            job.items[d.second].error = GetLastError();
+        }
+    }
+
+    for (size_t i = 0; i < job.files.size(); ++i)
+    {
+        CopyFileEntry& f = job.files[i];
+        if (job.items[f.item].failed)
+        {
+            f.failed = true;
+            continue;
+        }
+        if (!f.chunksLeft || f.resumed) continue;
+
+        // A partial copy kept from an earlier run that cannot be resumed
+        // starts over. The final name is claimed when the copy is renamed.
+        HANDLE h = CreateFileW(PartialCopyPath(f.dst).c_str(), GENERIC_WRITE, 0, NULL,
+                               CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+        bool ok = (h != INVALID_HANDLE_VALUE);
+        if (ok)
+        {
+            LARGE_INTEGER li;
+            li.QuadPart = (LONGLONG)f.size;
+            f.created = true;
+            ok = SetFilePointerEx(h, li, NULL, FILE_BEGIN) && SetEndOfFile(h);
+            CloseHandle(h);
+        }
+        if (!ok) job.Fail(i, GetLastError());
+    }
+}
+
+struct CopyProgressCtx
+{
+    CopyJob* job;
+    IoSlot* slot;       // given up while the job is paused
+    ULONGLONG reported;
+};
+
+static DWORD CALLBACK CopyEngineProgress(LARGE_INTEGER, LARGE_INTEGER transferred,
+                                         LARGE_INTEGER, LARGE_INTEGER,
+                                         DWORD, DWORD, HANDLE, HANDLE, LPVOID lpData)
+{
+    CopyProgressCtx* ctx = reinterpret_cast<CopyProgressCtx*>(lpData);
+    if (!ctx->slot->Checkpoint()) return PROGRESS_CANCEL;
+    ULONGLONG now = (ULONGLONG)transferred.QuadPart;
+    if (now > ctx->reported)
+    {
+        ctx->job->bytesDone.fetch_add(now - ctx->reported, std::memory_order_relaxed);
+        IoGovernor_Throttle((double)(now - ctx->reported), ctx->job->cancel);
+        ctx->reported = now;
+    }
+    return ctx->job->Cancelled() ? PROGRESS_CANCEL : PROGRESS_CONTINUE;
+}
+
+// Verify mode: copy through the pipeline so the source is hashed while it is
+// read, then re-read only the copy and compare.
+static void CopyJob_CopyVerified(CopyJob& job, size_t i, CopyBuffers& bufs, IoSlot& slot)
+{
+    CopyFileEntry& f = job.files[i];
+    const ULONGLONG t0 = GetTickCount64();
+
+    const DWORD dstFlags = FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED | FILE_FLAG_SEQUENTIAL_SCAN;
+    // Each open's error is taken at once: the next call may reset it
+    DWORD err = 0;
+    HANDLE hs = OpenForPipelinedCopy(f.src, false, false);
+    if (hs == INVALID_HANDLE_VALUE) err = GetLastError();
+    HANDLE hd = INVALID_HANDLE_VALUE;
+    if (!err)
+    {
+        hd = CreateFileW(f.dst.c_str(), GENERIC_WRITE, FILE_SHARE_READ, NULL,
+                         f.exclusive ? CREATE_NEW : CREATE_ALWAYS, dstFlags, NULL);
+        if (hd == INVALID_HANDLE_VALUE) err = GetLastError();
+        if (err == ERROR_FILE_EXISTS && CopyJob_Reclaim(job, i))
+        {
+            hd = CreateFileW(f.dst.c_str(), GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, dstFlags, NULL);
+            err = (hd == INVALID_HANDLE_VALUE) ? GetLastError() : 0;
+        }
+    }
+
+    Xxh64 x;
+    if (!err)
+        err = PipelinedCopyRange(hs, hd, 0, f.size, false, bufs, &job.bytesDone, job.cancel, &x, &slot);
+    if (!err) SetFileTime(hd, NULL, NULL, &f.modified);
+    if (hs != INVALID_HANDLE_VALUE) CloseHandle(hs);
+    if (hd != INVALID_HANDLE_VALUE) CloseHandle(hd);
+
+    const ULONGLONG want = x.Digest();
+    ULONGLONG got = 0;
+    if (!err) err = HashFileRange(f.dst, 0, f.size, bufs, job.cancel, got, &slot);
+    if (!err && got != want)
+    {
+        LogLine(L"Paste: verify FAILED for \"%s\" (%016llx != %016llx)", f.dst.c_str(), got, want);
+        err = ERROR_CRC;
+    }
+    if (err)
+    {
+        if (hd != INVALID_HANDLE_VALUE) DeleteFileW(f.dst.c_str());
+        job.Fail(i, err);
+        return;
+    }
+
+    if (f.attrs & ~FILE_ATTRIBUTE_NORMAL & ~FILE_ATTRIBUTE_ARCHIVE)
+        SetFileAttributesW(f.dst.c_str(), f.attrs);
+    job.filesDone.fetch_add(1, std::memory_order_relaxed);
+    job.stats.RecordFile(GetTickCount64() - t0);
+    CopyJob_FileDone(job, i, &want);
+}
+
+static void CopyJob_CopyWhole(CopyJob& job, size_t i, CopyBuffers& bufs, IoSlot& slot)
+{
+    CopyFileEntry& f = job.files[i];
+    if (f.failed || job.Cancelled()) return;
+    if (job.verify)
+    {
+        CopyJob_CopyVerified(job, i, bufs, slot);
+        return;
+    }
+
+    const ULONGLONG t0 = GetTickCount64();
+    CopyProgressCtx ctx = { &job, &slot, 0 };
+    BOOL copied = CopyFileExW(f.src.c_str(), f.dst.c_str(), CopyEngineProgress, &ctx, NULL,
+                              f.exclusive ? COPY_FILE_FAIL_IF_EXISTS : 0);
+    if (!copied && GetLastError() == ERROR_FILE_EXISTS && CopyJob_Reclaim(job, i))
+        copied = CopyFileExW(f.src.c_str(), f.dst.c_str(), CopyEngineProgress, &ctx, NULL, 0);
+    if (copied)
+    {
+        if (f.size > ctx.reported)
+            job.bytesDone.fetch_add(f.size - ctx.reported, std::memory_order_relaxed);
+        job.filesDone.fetch_add(1, std::memory_order_relaxed);
+        job.stats.RecordFile(GetTickCount64() - t0);
+        CopyJob_FileDone(job, i);
+    }
+    else
+    {
+        job.Fail(i, GetLastError());
+    }
+}
+
+// Share the source's blocks; fall back to a normal copy if the clone is refused.
+// A clone is the source's own blocks, so there is nothing to verify.
+static void CopyJob_CloneFile(CopyJob& job, size_t i, CopyBuffers& bufs, IoSlot& slot)
+{
+    CopyFileEntry& f = job.files[i];
+    if (f.failed || job.Cancelled()) return;
+
+    const ULONGLONG t0 = GetTickCount64();
+    if (CloneFileBlocks(f.src, f.dst, f.size, f.modified, f.attrs) == 0)
+    {
+        job.bytesDone.fetch_add(f.size, std::memory_order_relaxed);
+        job.filesDone.fetch_add(1, std::memory_order_relaxed);
+        job.stats.RecordFile(GetTickCount64() - t0);
+        CopyJob_FileDone(job, i);
+        return;
+    }
+    CopyJob_CopyWhole(job, i, bufs, slot);
+}
+
+// Verify mode, resumed file: the chunks an earlier run copied were never
+// hashed in this one. Hash each on both sides into f.chunkHashes before the
+// file is finished (and a move drops its source). Returns 0 or a Win32 error.
+static DWORD CopyJob_VerifyResumed(CopyJob& job, size_t i, const std::wstring& partial,
+                                   CopyBuffers& bufs, IoSlot& slot)
+{
+    CopyFileEntry& f = job.files[i];
+    std::vector<ULONGLONG> offsets = f.doneChunks;
+    std::sort(offsets.begin(), offsets.end());
+    offsets.erase(std::unique(offsets.begin(), offsets.end()), offsets.end());
+    for (ULONGLONG off : offsets)
+    {
+        if (off + kCopyChunkBytes >= f.size) continue; // the tail was copied again
+        const ULONGLONG len = std::min(kCopyChunkBytes, f.size - off);
+        ULONGLONG want = 0, got = 0;
+        DWORD err = HashFileRange(f.src, off, len, bufs, job.cancel, want, &slot);
+        if (!err) err = HashFileRange(partial, off, len, bufs, job.cancel, got, &slot);
+        if (err) return err;
+        if (got != want)
+        {
+            LogLine(L"Paste: verify FAILED for resumed \"%s\" at offset %llu", f.dst.c_str(), off);
+            return ERROR_CRC;
+        }
+        f.chunkHashes[(size_t)(off / kCopyChunkBytes)] = got;
+    }
+    return 0;
+}
+
+// Copy [offset, offset+length) into the pre-sized .partial of a chunked file;
+// the last chunk renames it to the destination.
+static void CopyJob_CopyChunk(CopyJob& job, const CopyTask& t, CopyBuffers& bufs, IoSlot& slot)
+{
+    CopyFileEntry& f = job.files[t.file];
+    if (f.failed || job.Cancelled()) return;
+    const std::wstring partial = PartialCopyPath(f.dst);
+
+    EnterCriticalSection(&job.lock);
+    if (!f.startTick) f.startTick = GetTickCount64();
+    LeaveCriticalSection(&job.lock);
+
+    // Chunk offsets are multiples of kCopyChunkBytes, so aligned for unbuffered I/O
+    const bool unbuffered = g_cfg.unbufferedCopyMB > 0 &&
+                            f.size >= (ULONGLONG)g_cfg.unbufferedCopyMB << 20;
+    DWORD err = 0;
+    HANDLE hs = OpenForPipelinedCopy(f.src, false, unbuffered);
+    if (hs == INVALID_HANDLE_VALUE) err = GetLastError();
+    HANDLE hd = err ? INVALID_HANDLE_VALUE : OpenForPipelinedCopy(partial, true, unbuffered);
+    if (hd == INVALID_HANDLE_VALUE && !err) err = GetLastError();
+
+    Xxh64 x;
+    if (!err)
+        err = PipelinedCopyRange(hs, hd, t.offset, t.length, unbuffered, bufs,
+                                 &job.bytesDone, job.cancel, job.verify ? &x : nullptr, &slot);
+    if (!err && job.verify)
+    {
+        ULONGLONG got = 0;
+        err = HashFileRange(partial, t.offset, t.length, bufs, job.cancel, got, &slot);
+        if (!err && got != x.Digest())
+        {
+            LogLine(L"Paste: verify FAILED for \"%s\" at offset %llu", f.dst.c_str(), t.offset);
+            err = ERROR_CRC;
+        }
+        if (!err) f.chunkHashes[(size_t)(t.offset / kCopyChunkBytes)] = got;
+    }
+    // The chunk record must not reach the disk before the chunk does
+    if (!err && job.journal && job.journal->Active() && !FlushFileBuffers(hd)) err = GetLastError();
+
+    if (hs != INVALID_HANDLE_VALUE) CloseHandle(hs);
+    if (hd != INVALID_HANDLE_VALUE) CloseHandle(hd);
+
+    // Counted down only after the close: a later close could move the mtime
+    bool last = false;
+    if (err)
+    {
+        job.Fail(t.file, err);
+    }
+    else
+    {
+        if (job.journal)
+            job.journal->Append(L"chunk\t%llu\t%llu\t%llu\t%s", t.offset,
+                                f.size, FileTimeU64(f.modified), f.dst.c_str());
+        EnterCriticalSection(&job.lock);
+        last = (--f.chunksLeft == 0) && !f.failed;
+        LeaveCriticalSection(&job.lock);
+    }
+    if (!last) return;
+
+    if (job.verify && f.resumed)
+    {
+        err = CopyJob_VerifyResumed(job, t.file, partial, bufs, slot);
+        if (err)
+        {
+            // Its journaled chunks cannot be trusted: the next run starts over
+            if (err == ERROR_CRC) DeleteFileW(partial.c_str());
+            job.Fail(t.file, err);
+            return;
+        }
+    }
+
+    // Every chunk handle is closed now; finish the file on a handle of its own
+    HANDLE hf = CreateFileW(partial.c_str(), GENERIC_WRITE, FILE_SHARE_READ, NULL,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hf == INVALID_HANDLE_VALUE)
+    {
+        job.Fail(t.file, GetLastError());
+        return;
+    }
+    // Unbuffered writes round the tail up to a sector; cut it back
+    FILE_END_OF_FILE_INFO eof;
+    eof.EndOfFile.QuadPart = (LONGLONG)f.size;
+    if (unbuffered) SetFileInformationByHandle(hf, FileEndOfFileInfo, &eof, sizeof(eof));
+    SetFileTime(hf, NULL, NULL, &f.modified);
+    CloseHandle(hf);
+
+    // A name from the resolver may have been taken meanwhile: claim another
+    BOOL renamed = MoveFileExW(partial.c_str(), f.dst.c_str(),
+                               f.exclusive ? 0 : MOVEFILE_REPLACE_EXISTING);
+    DWORD renameErr = renamed ? 0 : GetLastError();
+    if (renameErr == ERROR_ALREADY_EXISTS && CopyJob_Reclaim(job, t.file))
+    {
+        renamed = MoveFileExW(partial.c_str(), f.dst.c_str(), MOVEFILE_REPLACE_EXISTING);
+        renameErr = renamed ? 0 : GetLastError();
+    }
+    if (renameErr)
+    {
+        job.Fail(t.file, renameErr);
+        return;
+    }
+    job.filesDone.fetch_add(1, std::memory_order_relaxed);
+    job.stats.RecordFile(GetTickCount64() - f.startTick);
+
+    if (f.attrs & ~FILE_ATTRIBUTE_NORMAL & ~FILE_ATTRIBUTE_ARCHIVE)
+        SetFileAttributesW(f.dst.c_str(), f.attrs);
+    if (job.verify)
+    {
+        // File hash: XXH64 over the chunk hashes
+        Xxh64 fx;
+        fx.Update(f.chunkHashes.data(), f.chunkHashes.size() * sizeof(ULONGLONG));
+        const ULONGLONG digest = fx.Digest();
+        CopyJob_FileDone(job, t.file, &digest);
+    }
+    else
+    {
+        CopyJob_FileDone(job, t.file);
+    }
+}
+
+static DWORD WINAPI CopyWorkerProc(LPVOID p)
+{
+    CopyJob& job = *(CopyJob*)p;
+    CopyBuffers bufs; // allocated on first use
+    bool background = false;
+
+    for (;;)
+    {
+        EnterCriticalSection(&job.lock);
+        size_t ti = job.nextTask < job.tasks.size() ? job.nextTask++ : SIZE_MAX;
+        LeaveCriticalSection(&job.lock);
+        if (ti == SIZE_MAX || job.Cancelled()) break;
+        if (job.owner && !job.owner->WaitWhilePaused()) break;
+
+        const CopyTask& t = job.tasks[ti];
+        const CopyItemState& it =
+            job.items[job.files[t.kind == CopyTask::Batch ? job.smallOrder[t.first] : t.file].item];
+        IoGovernor_ThreadMode(background);
+        IoSlot slot(it.srcDev, it.dstDev, job.cancel);
+        if (!slot.ok) break;
+        if (job.owner) slot.paused = &job.owner->paused;
+
+        switch (t.kind)
+        {
+        case CopyTask::Batch:
+            for (size_t k = 0; k < t.count && !job.Cancelled() && slot.Checkpoint(); ++k)
+                CopyJob_CopyWhole(job, job.smallOrder[t.first + k], bufs, slot);
+            break;
+        case CopyTask::Whole:
+            CopyJob_CopyWhole(job, t.file, bufs, slot);
+            break;
+        case CopyTask::Chunk:
+            CopyJob_CopyChunk(job, t, bufs, slot);
+            break;
+        case CopyTask::Clone:
+            CopyJob_CloneFile(job, t.file, bufs, slot);
+            break;
+        }
     }
-    return true;
+    // May have run inline on the UI thread
+    if (background) SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_END);
+    return 0;
 }
 
-static bool CopyDirectoryTree(const std::wstring& srcDirIn,
-                              const std::wstring& dstDirIn,
-                              OpUI* op,
-                              BOOL* uiCancel)
+// Run the planned tasks on the worker pool; the calling job thread calls
+// onTick about every 100 ms until all workers are done.
+template <class Tick>
+static void CopyJob_Run(CopyJob& job, Tick onTick)
 {
-    std::wstring srcDir = EnsureSlash(srcDirIn);
-    std::wstring dstDir = EnsureSlash(dstDirIn);
+    CopyJob_PlanTasks(job);
+    CopyJob_MakeSkeleton(job);
+    job.stats.Begin(job.totalBytes, job.files.size(), job.bytesDone.load());
 
-    if (!CreateDirectoryW(dstDir.c_str(), NULL))
+    int streams = std::max(1, std::min(g_cfg.copyStreams, 16));
+    streams = (int)std::min<size_t>((size_t)streams, std::max<size_t>(1, job.tasks.size()));
+
+    std::vector<HANDLE> threads;
+    for (int i = 0; i < streams; ++i)
     {
-        DWORD e = GetLastError();
-        if (e != ERROR_ALREADY_EXISTS)
-        {
-            return false;
-        }
+        HANDLE h = CreateThread(NULL, 0, CopyWorkerProc, &job, 0, NULL);
+        if (h) threads.push_back(h);
     }
+    if (threads.empty()) CopyWorkerProc(&job); // no threads: do it inline
 
-    WIN32_FIND_DATAW fd{};
-    HANDLE h = FindFirstFileW((srcDir + L"*").c_str(), &fd);
-    if (h == INVALID_HANDLE_VALUE)
+    while (!threads.empty() &&
+            WaitForMultipleObjects((DWORD)threads.size(), threads.data(), TRUE, 100) == WAIT_TIMEOUT)
     {
-        return true;
+        onTick();
     }
+    for (HANDLE h : threads) CloseHandle(h);
 
-    do
+    // Chunked files that did not finish are partial: remove them, unless the
+    // journal keeps them for a resume
+    for (const auto& f : job.files)
     {
-        if (wcscmp(fd.cFileName, L".") == 0 ||
-                wcscmp(fd.cFileName, L"..") == 0)
-            continue;
-
-        if (op && op->cancel.load(std::memory_order_relaxed))
-        {
-            FindClose(h);
-            return false;
-        }
-        if (uiCancel && *uiCancel)
-        {
-            FindClose(h);
-            return false;
-        }
-
-        std::wstring srcPath = srcDir + fd.cFileName;
-        std::wstring dstPath = dstDir + fd.cFileName;
-
-        bool isDir = (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
-        bool isReparse = (fd.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0;
-
-        if (isDir && !isReparse)
-        {
-            if (!CopyDirectoryTree(srcPath, dstPath, op, uiCancel))
-            {
-                FindClose(h);
-                return false;
-            }
-        }
-        else
-        {
-            BOOL ok = CopyFileExW(
-                          srcPath.c_str(), dstPath.c_str(),
-                          CopyProgressThunk, op, uiCancel, 0);
-            if (!ok)
-            {
-                FindClose(h);
-                return false;
-            }
-        }
+        if (job.journal && job.journal->Active()) break;
+        if (f.created && (f.chunksLeft > 0 || f.failed))
+            DeleteFileW(PartialCopyPath(f.dst).c_str());
     }
-    while (FindNextFileW(h, &fd));
-    FindClose(h);
-    return true;
+    onTick();
 }
 
-// Run the copy/move with UI and cancellation (files + directories)
-// NOTE: requires: enum class OpResult { Success, Cancelled, Failed };
-
-static OpResult RunClipboardOperationWithUI(const std::wstring& dstFolder)
+// One paste: the clipboard entries and where they go
+struct PasteRequest
 {
-    if (g_clipMode == ClipMode::None || g_clipFiles.empty())
-        return OpResult::Failed;
+    std::vector<std::wstring> files;
+    bool isCopy = true;
+    std::wstring dstFolder;
+    bool resume = false;      // continue an earlier run from its journal
+};
 
-    const bool   isCopy = (g_clipMode == ClipMode::Copy);
-    const size_t total = g_clipFiles.size();
+// Copy/move files and directories; runs on a job thread
+// outcome: what happened to each entry, for the search results
+static bool RunPasteJob(Job& owner, const PasteRequest& req, std::vector<PathChange>& outcome)
+{
+    const bool   isCopy = req.isCopy;
+    const std::wstring& dstFolder = req.dstFolder;
+    const size_t total = req.files.size();
 
     bool allOk = true;
     bool cancelled = false;
 
-    auto makeCaption = [&](size_t currentIndex) -> std::wstring
-    {
-        if (total <= 1) return std::wstring(isCopy ? L"Copying..." : L"Moving...");
-        wchar_t buf[256];
-        swprintf_s(buf, L"%s... %zu of %zu",
-                   isCopy ? L"Copying" : L"Moving",
-                   currentIndex, total);
-        return buf;
-    };
-
-    std::wstring initialCap = makeCaption(total > 1 ? 1 : 0);
-    HWND hw = CreateOpWindow(initialCap.c_str());
-    if (!hw)
-    {
-        // Keep clipboard state so user can retry
-        return OpResult::Failed;
-    }
-
-    HFONT hf = (HFONT)GetStockObject(DEFAULT_GUI_FONT);
-    if (g_op.hText) SendMessageW(g_op.hText, WM_SETFONT, (WPARAM)hf, TRUE);
-
-    BOOL uiCancel = FALSE;
-    g_op.pCancelFlag = &uiCancel;
-    g_op.cancel.store(false, std::memory_order_relaxed);
-
-    auto updateCaption = [&](size_t idx1based)
-    {
-        if (IsWindow(g_op.hwnd))
-        {
-            std::wstring cap = makeCaption(idx1based);
-            SetWindowTextW(hw, cap.c_str());
-            UpdateWindow(hw);
-        }
-    };
+    // A retry continues where the failed or cancelled run stopped
+    CopyJournal journal;
+    const bool resume = CopyJournal_Load(journal, isCopy, dstFolder, req.files) &&
+                        (req.resume || owner.retry);
+    CopyJournal_Start(journal, resume, isCopy, dstFolder, req.files);
 
     auto setStatusText = [&](const std::wstring& s)
     {
-        if (IsWindow(g_op.hwnd) && g_op.hText)
-        {
-            SetWindowTextW(g_op.hText, s.c_str());
-            UpdateWindow(hw);
-        }
+        owner.SetStatus(s);
     };
 
     // strip trailing slashes (robust against "C:\foo\")
@@ -2116,24 +6978,40 @@ static OpResult RunClipboardOperationWithUI(const std::wstring& dstFolder)
         return _wcsnicmp(parent.c_str(), child.c_str(), parent.size()) == 0;
     };
 
+    // 1) Plan: same-volume moves are renames and happen right away; everything
+    //    else is scanned into one CopyJob so all of it shares the worker pool.
+    CopyJob job;
+    job.cancel = &owner.cancel;
+    job.owner = &owner;
+    job.journal = &journal;
+    job.verify = g_cfg.copyVerify;
+    job.move = !isCopy;
+    job.items.resize(total);
+    const bool dstClones = VolumeSupportsBlockClone(dstFolder);
+    NameResolver names;
+    names.Load(dstFolder);
+    job.names = &names;
+
     for (size_t i = 0; i < total; ++i)
     {
-        if (g_op.cancel.load(std::memory_order_relaxed))
+        if (!owner.WaitWhilePaused())
         {
             cancelled = true;
             break;
         }
 
-        std::wstring src = StripTrailingSlashes(g_clipFiles[i]);
-        DWORD attrs = GetFileAttributesW(src.c_str());
-        if (attrs == INVALID_FILE_ATTRIBUTES)
+        CopyItemState& item = job.items[i];
+        item.failed = true; // until it is planned
+
+        std::wstring src = StripTrailingSlashes(req.files[i]);
+        WIN32_FILE_ATTRIBUTE_DATA fad{};
+        if (!GetFileAttributesExW(src.c_str(), GetFileExInfoStandard, &fad))
         {
             allOk = false;
             continue;
         }
-
+        const DWORD attrs = fad.dwFileAttributes;
         const bool isDir = (attrs & FILE_ATTRIBUTE_DIRECTORY) != 0;
-        const bool isReparse = (attrs & FILE_ATTRIBUTE_REPARSE_POINT) != 0;
 
         // Base name (handles both '\' and '/')
         const wchar_t* base = wcsrchr(src.c_str(), L'\\');
@@ -2164,7 +7042,15 @@ static OpResult RunClipboardOperationWithUI(const std::wstring& dstFolder)
             }
         }
 
-        std::wstring dst = UniqueName(dstFolder, nameBase, nameExt);
+        // Resuming: continue into the destination the earlier run picked
+        std::wstring dst;
+        auto prev = journal.itemDst.find(i);
+        const bool reused = resume && prev != journal.itemDst.end() &&
+                            PathFileExistsW(prev->second.c_str());
+        if (reused)
+            dst = prev->second;
+        else
+            dst = names.Resolve(nameBase, nameExt);
 
         // Safety: don't paste a folder into itself / into its own subtree
         if (isDir)
@@ -2176,120 +7062,197 @@ static OpResult RunClipboardOperationWithUI(const std::wstring& dstFolder)
             }
         }
 
-        if (total > 1) updateCaption(i + 1);
-
-        std::wstring line = (isCopy ? L"Copying " : L"Moving ");
-        line += baseName;
-        line += L"...";
-        setStatusText(line);
-        PumpMessagesThrottled(10);
-
-        BOOL ok = FALSE;
-        uiCancel = FALSE;
-
-        if (isCopy)
+        if (!isCopy && SameVolume(src, dst))
         {
-            if (isDir)
+            // Fast rename/move within same volume/share
+            // (no replace: a name that appeared since the listing gets the next one)
+            setStatusText(L"Moving " + baseName + L"...");
+            BOOL moved = MoveFileExW(src.c_str(), dst.c_str(), 0);
+            for (int tries = 0; !moved && tries < 100 && (GetLastError() == ERROR_ALREADY_EXISTS ||
+                                                          GetLastError() == ERROR_FILE_EXISTS); ++tries)
             {
-                // If it's a reparse-point dir (junction/symlink), CopyDirectoryTree() will treat it as a file and fail.
-                // We keep existing behavior: treat failure as failure.
-                ok = CopyDirectoryTree(src, dst, &g_op, &uiCancel);
+                dst = names.Resolve(nameBase, nameExt);
+                moved = MoveFileExW(src.c_str(), dst.c_str(), 0);
             }
+            if (!moved)
+                allOk = false;
             else
-            {
-                ok = CopyFileExW(src.c_str(), dst.c_str(),
-                                 CopyProgressThunk, &g_op, &uiCancel, 0);
-            }
+                outcome.push_back({ src, dst });
+            continue;
         }
-        else
+
+        // Creating the top folder now is the exclusive check for its name
+        if (isDir && !reused && !CreateDirectoryW(dst.c_str(), NULL))
         {
-            // Move
-            if (SameVolume(src, dst))
-            {
-                // Fast rename/move within same volume/share
-                ok = MoveFileExW(src.c_str(), dst.c_str(),
-                                 MOVEFILE_REPLACE_EXISTING);
-            }
-            else
+            const DWORD err = GetLastError();
+            if (err != ERROR_ALREADY_EXISTS)
             {
-                // Cross-volume: copy then delete source
-                if (isDir)
-                {
-                    ok = CopyDirectoryTree(src, dst, &g_op, &uiCancel);
-                    if (ok)
-                    {
-                        if (!DeleteDirectoryTree(src))
-                        {
-                            // Copy succeeded but delete failed -> not a true move
-                            allOk = false;
-                        }
-                    }
-                    else
-                    {
-                        // Best-effort cleanup of partial destination
-                        DeleteDirectoryTree(dst);
-                    }
-                }
-                else
-                {
-                    ok = CopyFileExW(src.c_str(), dst.c_str(),
-                                     CopyProgressThunk, &g_op, &uiCancel, 0);
-                    if (ok)
-                    {
-                        ClearReadonlyAndSystem(src);
-                        if (!DeleteFileW(src.c_str()))
-                        {
-                            MoveFileExW(src.c_str(), NULL, MOVEFILE_DELAY_UNTIL_REBOOT);
-                            allOk = false;
-                        }
-                    }
-                    else
-                    {
-                        DeleteFileW(dst.c_str());
-                    }
-                }
+                LogLine(L"Paste: could not create \"%s\" (error %lu)", dst.c_str(), err);
+                item.error = err;
+                allOk = false;
+                continue;
             }
+            dst = names.Claim(nameBase, nameExt, true);
         }
 
-        if (!ok)
+        item.src = src;
+        item.dst = dst;
+        item.nameBase = nameBase;
+        item.nameExt = nameExt;
+        item.isDir = isDir;
+        item.clone = dstClones && SameVolume(src, dst);
+        item.srcDev = IoDeviceForPath(src);
+        item.dstDev = IoDeviceForPath(dstFolder);
+        item.failed = false;
+        journal.Append(L"item\t%zu\t%s", i, dst.c_str());
+
+        setStatusText(L"Scanning " + baseName + L"...");
+        if (isDir)
         {
-            allOk = false;
-            DWORD err = GetLastError();
-            if (uiCancel || g_op.cancel.load(std::memory_order_relaxed) ||
-                    err == ERROR_REQUEST_ABORTED || err == ERROR_CANCELLED)
-            {
-                cancelled = true;
-                break;
-            }
+            CopyJob_ScanDir(job, src, dst, (int)i);
         }
-
-        if (g_op.cancel.load(std::memory_order_relaxed) || uiCancel)
+        else
         {
-            cancelled = true;
-            break;
+            ULARGE_INTEGER uli;
+            uli.HighPart = fad.nFileSizeHigh;
+            uli.LowPart = fad.nFileSizeLow;
+            CopyJob_AddFile(job, src, dst, uli.QuadPart, fad.ftLastWriteTime, attrs, (int)i);
+            job.files.back().exclusive = !reused;
         }
+    }
 
-        setStatusText(line + L" Done");
-        PumpMessagesThrottled(10);
+    // 2) Copy everything on the worker pool
+    bool planned = false;
+    for (const auto& it : job.items) planned = planned || !it.src.empty();
+    if (resume && planned) CopyJob_ApplyJournal(job, journal);
 
-        if (total > 1 && (i + 1) < total) updateCaption(i + 2);
+    if (!cancelled && planned)
+    {
+        CopyJob_Run(job, [&]()
+        {
+            const ULONGLONG done = job.bytesDone.load(std::memory_order_relaxed);
+            wchar_t buf[256];
+            swprintf_s(buf, L"%s %zu of %zu files",
+                       isCopy ? L"Copying" : L"Moving",
+                       job.filesDone.load(std::memory_order_relaxed), job.files.size());
+            setStatusText(buf);
+            job.stats.Sample(done);
+            owner.SetDetail(job.stats.Describe(done),
+                            job.totalBytes ? (int)(done * 1000 / job.totalBytes) : 1000);
+        });
+        LogLine(L"Paste: %zu task(s), %d stream(s)%s%s: %s",
+                job.tasks.size(), g_cfg.copyStreams, job.verify ? L", verified" : L"",
+                job.Cancelled() ? L" (cancelled)" : L"",
+                job.stats.Summary(job.bytesDone.load(), job.filesDone.load()).c_str());
+        if (job.Cancelled()) cancelled = true;
     }
 
-    // Close progress window (if user already cancelled, it may already be gone)
-    if (IsWindow(g_op.hwnd)) DestroyWindow(g_op.hwnd);
+    // 3) Per clipboard entry: finish moves. Moved files already left their
+    // source; a move that stopped part way stays split between both sides,
+    // which loses nothing.
+    for (size_t i = 0; i < job.items.size(); ++i)
+    {
+        const CopyItemState& it = job.items[i];
+        if (it.src.empty()) continue;
+        if (it.failed) allOk = false;
+
+        // A failed or cancelled folder leaves no empty destination folders behind
+        if (it.isDir && (it.failed || cancelled))
+        {
+            for (size_t d = job.dirs.size(); d-- > 0; )
+                if (job.dirs[d].second == (int)i)
+                    RemoveDirectoryW(StripTrailingSlashes(job.dirs[d].first).c_str());
+        }
+        outcome.push_back({ L"", it.dst });
+        if (isCopy) continue;
+        if (!it.isDir)
+        {
+            if (!PathFileExistsW(it.src.c_str())) outcome.push_back({ it.src, L"" });
+            continue;
+        }
 
-    // IMPORTANT: pointer was to a local stack var
-    g_op.pCancelFlag = nullptr;
+        // Remove emptied directories bottom-up; those still holding files stay
+        for (size_t d = job.dirs.size(); d-- > 0; )
+        {
+            if (job.dirs[d].second != (int)i) continue;
+            ClearReadonlyAndSystem(job.srcDirs[d]);
+            RemoveDirectoryW(StripTrailingSlashes(job.srcDirs[d]).c_str());
+        }
 
-    // Clear internal clipboard state (per your original design)
-    g_clipFiles.clear();
-    g_clipMode = ClipMode::None;
+        // Anything the scan did not carry over (created meanwhile, or a folder
+        // it could not list) was never copied: it stays, and the move failed
+        if (!it.failed && !cancelled && PathFileExistsW(it.src.c_str()))
+        {
+            LogLine(L"Move: \"%s\" still holds items that were not moved", it.src.c_str());
+            allOk = false;
+        }
+
+        // Whatever is left of the source is read again
+        if (PathFileExistsW(it.src.c_str())) outcome.push_back({ L"", it.src });
+        else outcome.push_back({ it.src, L"" });
+    }
+
+    // Keep the journal only if there is something to come back to
+    CopyJournal_Finish(journal, planned && (cancelled || !allOk));
 
-    // Refresh view if we're in a folder
-    if (g_view == ViewKind::Folder) ShowFolder(g_folder);
+    wchar_t buf[128];
+    swprintf_s(buf, L"%zu of %zu files %s%s", job.filesDone.load(), job.files.size(),
+               isCopy ? L"copied" : L"moved", allOk || cancelled ? L"" : L", some failed");
+    setStatusText(buf);
+    return allOk && !cancelled;
+}
 
-    if (cancelled) return OpResult::Cancelled;
-    return allOk ? OpResult::Success : OpResult::Failed;
+// Queue the paste of files into dstFolder as a background job
+static void Browser_QueuePaste(const std::wstring& dstFolder, std::vector<std::wstring> files,
+                               ClipMode mode, bool fromSysClipboard)
+{
+    PasteRequest req;
+    req.files = std::move(files);
+    req.isCopy = (mode == ClipMode::Copy);
+    req.dstFolder = dstFolder;
+
+    // An earlier run of this very paste that did not finish can be resumed
+    CopyJournal earlier;
+    if (CopyJournal_Load(earlier, req.isCopy, dstFolder, req.files))
+    {
+        req.resume = MessageBoxW(g_hwndMain,
+                                 L"An earlier paste of these items into this folder did not finish.\n\n"
+                                 L"Resume it? (No starts over.)",
+                                 L"Resume paste", MB_YESNO | MB_ICONQUESTION) == IDYES;
+    }
+
+    auto job = std::make_shared<Job>();
+    wchar_t title[MAX_PATH + 64];
+    const wchar_t* name = PathFindFileNameW(req.files[0].c_str());
+    if (req.files.size() == 1)
+        swprintf_s(title, L"%s \"%s\" to %s", req.isCopy ? L"Copy" : L"Move", name, dstFolder.c_str());
+    else
+        swprintf_s(title, L"%s %zu items to %s", req.isCopy ? L"Copy" : L"Move",
+                   req.files.size(), dstFolder.c_str());
+    job->title = title;
+    job->touched.push_back(dstFolder);
+    if (!req.isCopy)
+        for (const auto& f : req.files) job->touched.push_back(ParentDir(f));
+    auto outcome = std::make_shared<std::vector<PathChange>>();
+    job->run = [req, outcome](Job& j)
+    {
+        outcome->clear();
+        return RunPasteJob(j, req, *outcome);
+    };
+    // A finished cut must not be pasted again (unless the clipboard moved on)
+    const bool emptyClip = !req.isCopy && fromSysClipboard;
+    const DWORD seq = GetClipboardSequenceNumber();
+    job->finished = [outcome, emptyClip, seq](Job& j)
+    {
+        SearchResults_Apply(*outcome);
+        if (emptyClip && j.state.load() == JobState::Done && GetClipboardSequenceNumber() == seq &&
+                OpenClipboard(g_hwndMain))
+        {
+            EmptyClipboard();
+            CloseClipboard();
+        }
+    };
+    Jobs_Add(job);
 }
 
 static void Browser_PasteClipboardIntoCurrent()
@@ -2313,28 +7276,92 @@ static void Browser_PasteClipboardIntoCurrent()
     ClipMode sysMode = ClipMode::Copy;
     if (GetClipboardFileDrop(sysFiles, &sysMode))
     {
-        g_clipMode = sysMode;
-        g_clipFiles = std::move(sysFiles);
+        Browser_QueuePaste(dstFolder, std::move(sysFiles), sysMode, true);
+    }
+    // 2) Fallback to internal clipboard (Ctrl+C/X done inside this app)
+    else if (g_clipMode != ClipMode::None && !g_clipFiles.empty())
+    {
+        Browser_QueuePaste(dstFolder, g_clipFiles, g_clipMode, false);
+    }
+    else
+    {
+        return;
+    }
+
+    // Clear internal clipboard state (per your original design)
+    g_clipFiles.clear();
+    g_clipMode = ClipMode::None;
+}
 
-        OpResult r = RunClipboardOperationWithUI(dstFolder);
+// Delete paths in place on a job thread (for what the trash cannot take)
+static bool RunDeleteJob(Job& owner, const std::vector<std::wstring>& paths)
+{
+    size_t failed = 0;
+    for (size_t n = 0; n < paths.size(); ++n)
+    {
+        if (!owner.WaitWhilePaused()) return false;
+        wchar_t buf[64];
+        swprintf_s(buf, L"Deleting %zu of %zu", n + 1, paths.size());
+        owner.SetStatus(buf);
 
-        // Optional: if it was a CUT and we actually succeeded, clear clipboard
-        // (prevents stale "cut" source paths being pasted again)
-        if (sysMode == ClipMode::Move && r == OpResult::Success)
+        const std::wstring& path = paths[n];
+        DWORD attrs = GetFileAttributesW(path.c_str());
+        if (attrs == INVALID_FILE_ATTRIBUTES) continue;
+        if (attrs & FILE_ATTRIBUTE_DIRECTORY)
         {
-            if (OpenClipboard(g_hwndMain))
+            if (!DeleteDirectoryTree(path, false, &owner.cancel, &owner.paused))
             {
-                EmptyClipboard();
-                CloseClipboard();
+                if (owner.Cancelled()) return false;
+                ++failed;
+            }
+        }
+        else
+        {
+            ClearReadonlyAndSystem(path);
+            if (!DeleteFileW(path.c_str()))
+            {
+                MoveFileExW(path.c_str(), NULL, MOVEFILE_DELAY_UNTIL_REBOOT);
+                ++failed;
             }
         }
-        return;
     }
 
-    // 2) Fallback to internal clipboard (Ctrl+C/X done inside this app)
-    if (g_clipMode == ClipMode::None || g_clipFiles.empty()) return;
+    wchar_t buf[160];
+    if (failed)
+        swprintf_s(buf, L"%zu item(s) could not be deleted (locked, in use or access denied); "
+                   L"they may be deleted at the next reboot", failed);
+    else
+        swprintf_s(buf, L"%zu item(s) deleted", paths.size());
+    owner.SetStatus(buf);
+    return failed == 0;
+}
 
-    RunClipboardOperationWithUI(dstFolder);
+static void Browser_QueueDelete(std::vector<std::wstring> paths)
+{
+    auto job = std::make_shared<Job>();
+    wchar_t title[MAX_PATH + 32];
+    if (paths.size() == 1) swprintf_s(title, L"Delete \"%s\"", PathFindFileNameW(paths[0].c_str()));
+    else swprintf_s(title, L"Delete %zu items", paths.size());
+    job->title = title;
+    for (const auto& p : paths) job->touched.push_back(ParentDir(p));
+    job->run = [paths](Job& j)
+    {
+        return RunDeleteJob(j, paths);
+    };
+    // Search results are not re-read: drop what is gone, read again what is
+    // only partly deleted
+    job->finished = [paths](Job&)
+    {
+        std::vector<PathChange> changes;
+        for (const auto& p : paths)
+        {
+            const DWORD attrs = GetFileAttributesW(p.c_str());
+            if (attrs == INVALID_FILE_ATTRIBUTES) changes.push_back({ p, L"" });
+            else if (attrs & FILE_ATTRIBUTE_DIRECTORY) changes.push_back({ L"", p });
+        }
+        SearchResults_Apply(changes);
+    };
+    Jobs_Add(job);
 }
 
 static void Browser_DeleteSelected()
@@ -2353,65 +7380,61 @@ static void Browser_DeleteSelected()
 
     // First collect all selected paths so we don't care if the view changes
     std::vector<std::wstring> toDelete;
+    std::vector<int> rowIdx; // g_rows indices, parallel to toDelete
     int idx = -1;
     while ((idx = ListView_GetNextItem(g_hwndList, idx, LVNI_SELECTED)) != -1)
     {
-        if (idx < 0 || idx >= (int)g_rows.size()) continue;
-        toDelete.push_back(g_rows[idx].full);
+        const Row* r = RowAt(idx);
+        if (!r) continue;
+        toDelete.push_back(r->full);
+        rowIdx.push_back(g_visible[idx]);
     }
     if (toDelete.empty()) return;
 
-    bool anyFailed = false;
+    std::vector<int> gone;              // rows to drop from the view
+    std::vector<PathChange> changes;
+    std::vector<std::wstring> slow;     // could not be staged: deleted by a job
+    size_t staged = 0;
 
-    for (const auto& path : toDelete)
+    for (size_t n = 0; n < toDelete.size(); ++n)
     {
+        const std::wstring& path = toDelete[n];
         DWORD attrs = GetFileAttributesW(path.c_str());
         if (attrs == INVALID_FILE_ATTRIBUTES)
-            continue;
-
-        if (attrs & FILE_ATTRIBUTE_DIRECTORY)
         {
-            if (!DeleteDirectoryTree(path))
-            {
-                anyFailed = true;
-            }
+            gone.push_back(rowIdx[n]);
+            changes.push_back({ path, L"" });
+            continue;
         }
-        else
+
+        // Usually instant: the purge worker does the real work later
+        if (TrashStage(path))
         {
-            ClearReadonlyAndSystem(path);
-            if (!DeleteFileW(path.c_str()))
-            {
-                MoveFileExW(path.c_str(), NULL, MOVEFILE_DELAY_UNTIL_REBOOT);
-                anyFailed = true;
-            }
+            gone.push_back(rowIdx[n]);
+            changes.push_back({ path, L"" });
+            ++staged;
+            continue;
         }
+        slow.push_back(path);
     }
+    LogLine(L"Delete: %zu item(s), %zu staged for purge", toDelete.size(), staged);
 
-    // Refresh whichever view we're in so the UI matches disk state
-    if (g_view == ViewKind::Search && g_search.active)
-    {
-        std::vector<Row> res;
-        RunSearchFromOrigin(res);
-        ShowSearchResults(res);
-    }
-    else if (g_view == ViewKind::Folder)
-    {
-        ShowFolder(g_folder);
-    }
-    else if (g_view == ViewKind::Drives)
+    // Drop the deleted rows instead of re-reading the folder or re-running the search
+    if (g_view == ViewKind::Folder)
     {
-        ShowDrives();
+        std::sort(gone.begin(), gone.end());
+        for (int n = (int)gone.size() - 1; n >= 0; --n)
+        {
+            if (gone[n] >= 0 && gone[n] < (int)g_rows.size())
+                g_rows.erase(g_rows.begin() + gone[n]);
+        }
+        RebuildVisible(false);
+        LV_SyncItemCount(true);
+        SetTitleFolderOrDrives();
     }
+    SearchResults_Apply(changes);
 
-    if (anyFailed)
-    {
-        MessageBoxW(
-            g_hwndMain,
-            L"Some items could not be deleted (locked, in use, or permission denied).\n"
-            L"They may have been queued for deletion on next reboot.",
-            L"Delete",
-            MB_OK | MB_ICONWARNING);
-    }
+    if (!slow.empty()) Browser_QueueDelete(std::move(slow));
 }
 
 // ----------------------------- Save-As helper (used in playback rename/copy)
@@ -2584,38 +7607,272 @@ static void EnsureKwClassRegistered()
         wc.hInstance = g_hInst;
         wc.hCursor = LoadCursor(NULL, IDC_ARROW);
         wc.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
-        wc.lpszClassName = L"KwPromptClass";
-        wc.style = CS_DBLCLKS;
+        wc.lpszClassName = L"KwPromptClass";
+        wc.style = CS_DBLCLKS;
+        RegisterClassW(&wc);
+        reg = true;
+    }
+}
+
+// ----------------------------- Live search box (search-as-you-type)
+
+struct LiveSearchCtx
+{
+    HWND hwnd, hEdit, hMode, hOK, hCancel;
+    bool accepted;
+    std::wstring initial;
+    SearchMode initialMode;
+};
+static LiveSearchCtx g_live = { 0,0,0,0,0,false,L"",SearchMode::Words };
+
+// Match the snapshot against the typed text and show it in the Search view.
+static void LiveSearch_Apply()
+{
+    int len = GetWindowTextLengthW(g_live.hEdit);
+    std::wstring text(len, L'\0');
+    if (len > 0) GetWindowTextW(g_live.hEdit, &text[0], len + 1);
+
+    int sel = (int)SendMessageW(g_live.hMode, CB_GETCURSEL, 0, 0);
+    g_search.mode = (sel >= 0 && sel <= (int)SearchMode::Regex) ? (SearchMode)sel : SearchMode::Words;
+    g_search.query = text;
+    g_search.queryLower = ToLower(text);
+    SplitTerms(g_search.queryLower, g_search.termsLower);
+
+    // Say so in the box caption while a pattern does not parse
+    std::wstring err;
+    SearchMatcher m;
+    if (!Trim(text).empty() && !BuildSearchMatcher(m, &err))
+        SetWindowTextW(g_live.hwnd, (L"Search - " + err).c_str());
+    else
+        SetWindowTextW(g_live.hwnd, L"Search");
+
+    QuerySnapshot(g_rows);
+    ShowSearchRows();
+}
+
+static LRESULT CALLBACK LiveEditSub(HWND h, UINT m, WPARAM w, LPARAM l,
+                                    UINT_PTR, DWORD_PTR)
+{
+    if (m == WM_KEYDOWN)
+    {
+        if (w == VK_RETURN)
+        {
+            PostMessageW(GetParent(h), WM_COMMAND,
+                         MAKELONG(IDOK, BN_CLICKED),
+                         (LPARAM)g_live.hOK);
+            return 0;
+        }
+        if (w == VK_ESCAPE)
+        {
+            PostMessageW(GetParent(h), WM_COMMAND,
+                         MAKELONG(IDCANCEL, BN_CLICKED),
+                         (LPARAM)g_live.hCancel);
+            return 0;
+        }
+    }
+    return DefSubclassProc(h, m, w, l);
+}
+
+static LRESULT CALLBACK LiveSearchProc(HWND h, UINT m, WPARAM w, LPARAM l)
+{
+    switch (m)
+    {
+    case WM_CREATE:
+    {
+        HFONT hf = (HFONT)GetStockObject(DEFAULT_GUI_FONT);
+        RECT rc;
+        GetClientRect(h, &rc);
+        int margin = DpiScale(12);
+        int btnW = DpiScale(90), btnH = DpiScale(28);
+        int labelH = DpiScale(20);
+        int editH = DpiScale(24);
+
+        HWND hLbl = CreateWindowExW(
+                        0, L"STATIC", L"Search videos as you type (Words / Fuzzy / Glob like S0?E* / Regex):",
+                        WS_CHILD | WS_VISIBLE,
+                        margin, margin,
+                        rc.right - 2 * margin, labelH,
+                        h, NULL, g_hInst, NULL);
+        SendMessageW(hLbl, WM_SETFONT, (WPARAM)hf, TRUE);
+
+        g_live.hEdit = CreateWindowExW(
+                           WS_EX_CLIENTEDGE, L"EDIT", L"",
+                           WS_CHILD | WS_VISIBLE | ES_AUTOHSCROLL,
+                           margin, margin + labelH + DpiScale(6),
+                           rc.right - 2 * margin - (btnW + DpiScale(10)),
+                           editH,
+                           h, (HMENU)201, g_hInst, NULL);
+        SendMessageW(g_live.hEdit, WM_SETFONT, (WPARAM)hf, TRUE);
+        SetWindowSubclass(g_live.hEdit, LiveEditSub, 12, 0);
+
+        g_live.hMode = CreateWindowExW(
+                           0, WC_COMBOBOXW, L"",
+                           WS_CHILD | WS_VISIBLE | WS_TABSTOP | CBS_DROPDOWNLIST,
+                           rc.right - margin - btnW, margin + labelH + DpiScale(6),
+                           btnW, DpiScale(200),
+                           h, (HMENU)202, g_hInst, NULL);
+        SendMessageW(g_live.hMode, WM_SETFONT, (WPARAM)hf, TRUE);
+        SendMessageW(g_live.hMode, CB_ADDSTRING, 0, (LPARAM)L"Words");
+        SendMessageW(g_live.hMode, CB_ADDSTRING, 0, (LPARAM)L"Fuzzy");
+        SendMessageW(g_live.hMode, CB_ADDSTRING, 0, (LPARAM)L"Glob");
+        SendMessageW(g_live.hMode, CB_ADDSTRING, 0, (LPARAM)L"Regex");
+        SendMessageW(g_live.hMode, CB_SETCURSEL, (WPARAM)g_live.initialMode, 0);
+
+        int btnY = rc.bottom - margin - btnH;
+        g_live.hOK = CreateWindowExW(
+                         0, L"BUTTON", L"OK",
+                         WS_CHILD | WS_VISIBLE | BS_DEFPUSHBUTTON,
+                         rc.right - margin - btnW - (btnW + DpiScale(10)),
+                         btnY,
+                         btnW, btnH, h, (HMENU)IDOK, g_hInst, NULL);
+        SendMessageW(g_live.hOK, WM_SETFONT, (WPARAM)hf, TRUE);
+
+        g_live.hCancel = CreateWindowExW(
+                             0, L"BUTTON", L"Cancel",
+                             WS_CHILD | WS_VISIBLE,
+                             rc.right - margin - btnW, btnY,
+                             btnW, btnH, h, (HMENU)IDCANCEL, g_hInst, NULL);
+        SendMessageW(g_live.hCancel, WM_SETFONT, (WPARAM)hf, TRUE);
+
+        // Set the seed text before the EN_CHANGE handler can see it
+        if (!g_live.initial.empty())
+        {
+            SetWindowTextW(g_live.hEdit, g_live.initial.c_str());
+            int n = (int)g_live.initial.size();
+            SendMessageW(g_live.hEdit, EM_SETSEL, n, n);
+        }
+
+        SetFocus(g_live.hEdit);
+        return 0;
+    }
+    case WM_COMMAND:
+        if (LOWORD(w) == 201 && HIWORD(w) == EN_CHANGE)
+        {
+            // Coalesce bursts of typing; the narrowing itself is cheap,
+            // re-populating the list is not.
+            SetTimer(h, kTimerLiveSearch, 80, NULL);
+            return 0;
+        }
+        if (LOWORD(w) == 202 && HIWORD(w) == CBN_SELCHANGE)
+        {
+            SetTimer(h, kTimerLiveSearch, 0, NULL);
+            SetFocus(g_live.hEdit);
+            return 0;
+        }
+        if (LOWORD(w) == IDOK)
+        {
+            KillTimer(h, kTimerLiveSearch);
+            LiveSearch_Apply();
+            g_live.accepted = !Trim(g_search.queryLower).empty();
+            DestroyWindow(h);
+            return 0;
+        }
+        if (LOWORD(w) == IDCANCEL)
+        {
+            g_live.accepted = false;
+            DestroyWindow(h);
+            return 0;
+        }
+        break;
+    case WM_TIMER:
+        if (w == kTimerLiveSearch)
+        {
+            KillTimer(h, kTimerLiveSearch);
+            LiveSearch_Apply();
+            return 0;
+        }
+        break;
+    case WM_CLOSE:
+        g_live.accepted = false;
+        DestroyWindow(h);
+        return 0;
+    case WM_DESTROY:
+        KillTimer(h, kTimerLiveSearch);
+        g_live.hwnd = NULL;
+        return 0;
+    }
+    return DefWindowProcW(h, m, w, l);
+}
+
+// Ctrl+F: open the live search box. From Folder/Drives view it starts a new
+// search (scoped to the selection, if any); in Search view it refines the
+// current query. Esc restores whatever was shown before.
+static void RunLiveSearch()
+{
+    static bool s_running = false;
+    if (s_running) return;
+    s_running = true;
+
+    static bool reg = false;
+    if (!reg)
+    {
+        WNDCLASSW wc;
+        ZeroMemory(&wc, sizeof(wc));
+        wc.lpfnWndProc = LiveSearchProc;
+        wc.hInstance = g_hInst;
+        wc.hCursor = LoadCursor(NULL, IDC_ARROW);
+        wc.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
+        wc.lpszClassName = L"LiveSearchClass";
         RegisterClassW(&wc);
         reg = true;
     }
-}
 
-static bool PromptKeyword(std::wstring& out)
-{
-    EnsureKwClassRegistered();
-    g_kw = KwCtx();
-    g_kw.accepted = false;
-    g_kw.label = L"Search keyword (case-insensitive):";
-    g_kw.title = L"Search";
-    g_kw.initial.clear();
+    const bool wasSearch = (g_view == ViewKind::Search);
+    const ViewKind prevView = g_view;
+    const std::wstring prevFolder = g_folder;
+    const SearchState prevSearch = g_search;
+    std::vector<Row> prevRows = g_rows;
+    NavCache_Save(); // Esc or leaving the search comes back to it
 
-    MONITORINFO mi;
-    mi.cbSize = sizeof(mi);
-    HMONITOR hm = MonitorFromWindow(g_hwndMain, MONITOR_DEFAULTTONEAREST);
-    GetMonitorInfoW(hm, &mi);
-    RECT wa = mi.rcWork;
+    static SearchMode s_lastMode = SearchMode::Words;
 
-    int W = DpiScale(600), H = DpiScale(160);
-    int X = wa.left + ((wa.right - wa.left) - W) / 2;
-    int Y = wa.top + ((wa.bottom - wa.top) - H) / 2;
+    g_live = LiveSearchCtx();
+    g_live.accepted = false;
+    g_live.initialMode = s_lastMode;
+
+    if (!wasSearch)
+    {
+        g_search = SearchState();
+        g_search.active = true;
+        g_search.originView = g_view;
+        g_search.originFolder = (g_view == ViewKind::Folder ? g_folder : L"");
+
+        std::vector<std::wstring> selFolders, selFiles;
+        CollectSelection(selFolders, selFiles);
+        if (!selFolders.empty() || !selFiles.empty())
+        {
+            g_search.useExplicitScope = true;
+            g_search.explicitFolders.swap(selFolders);
+            g_search.explicitFiles.swap(selFiles);
+        }
+    }
+    else
+    {
+        // Seed with the current query so typing refines it
+        g_live.initial = g_search.query;
+        g_live.initialMode = g_search.mode;
+        if (g_search.mode == SearchMode::Words && !g_live.initial.empty() &&
+                !iswspace(g_live.initial.back()))
+        {
+            g_live.initial += L' ';
+        }
+    }
+
+    EnsureSearchSnapshot();
+    if (!wasSearch) SetTitleFolderOrDrives(); // clear crawl progress from the title
+
+    RECT mr;
+    GetWindowRect(g_hwndMain, &mr);
+    int W = DpiScale(600), H = DpiScale(130);
+    int X = mr.left + ((mr.right - mr.left) - W) / 2;
+    int Y = mr.top + DpiScale(60);
 
     HWND hwnd = CreateWindowExW(
                     WS_EX_DLGMODALFRAME | WS_EX_TOPMOST,
-                    L"KwPromptClass",
-                    g_kw.title.c_str(),
+                    L"LiveSearchClass", L"Search",
                     WS_POPUPWINDOW | WS_CAPTION | WS_SYSMENU | WS_VISIBLE,
                     X, Y, W, H, g_hwndMain, NULL, g_hInst, NULL);
+    g_live.hwnd = hwnd;
 
     SetWindowPos(hwnd, HWND_TOPMOST, X, Y, W, H, SWP_SHOWWINDOW);
     SetForegroundWindow(hwnd);
@@ -2626,13 +7883,32 @@ static bool PromptKeyword(std::wstring& out)
         TranslateMessage(&msg);
         DispatchMessageW(&msg);
     }
-    if (g_kw.accepted)
+
+    if (!g_live.accepted)
     {
-        out = g_kw.text;
-        return true;
+        g_search = prevSearch;
+        if (wasSearch)
+        {
+            g_rows.swap(prevRows);
+            ShowSearchRows();
+        }
+        else if (prevView == ViewKind::Folder)
+        {
+            ShowFolderRows(prevFolder, std::move(prevRows));
+        }
+        else
+        {
+            ShowDrives();
+        }
+    }
+    else
+    {
+        s_lastMode = g_search.mode;
     }
+
     SetForegroundWindow(g_hwndMain);
-    return false;
+    SetFocus(g_hwndList);
+    s_running = false;
 }
 
 static bool PromptRenameSimple(const std::wstring& currentName, std::wstring& out)
@@ -2683,10 +7959,10 @@ static void Browser_RenameSelected()
 {
     if (g_view == ViewKind::Drives) return;
 
-    int sel = ListView_GetNextItem(g_hwndList, -1, LVNI_SELECTED);
-    if (sel < 0 || sel >= (int)g_rows.size()) return;
+    const Row* sel = RowAt(ListView_GetNextItem(g_hwndList, -1, LVNI_SELECTED));
+    if (!sel) return;
 
-    const Row& r = g_rows[sel];
+    const Row& r = *sel;
     const wchar_t* base = wcsrchr(r.full.c_str(), L'\\');
     const wchar_t* name = base ? base + 1 : r.full.c_str();
 
@@ -2706,8 +7982,9 @@ static void Browser_RenameSelected()
         newPath = newName;
     }
 
+    const std::wstring oldPath = r.full;
     BOOL ok = MoveFileExW(
-                  r.full.c_str(), newPath.c_str(),
+                  oldPath.c_str(), newPath.c_str(),
                   MOVEFILE_COPY_ALLOWED | MOVEFILE_REPLACE_EXISTING);
     if (!ok)
     {
@@ -2718,40 +7995,95 @@ static void Browser_RenameSelected()
         return;
     }
 
-    if (g_view == ViewKind::Folder)
-    {
-        ShowFolder(g_folder);
-    }
-    else if (g_view == ViewKind::Search && g_search.active)
-    {
-        std::vector<Row> res;
-        RunSearchFromOrigin(res);
-        ShowSearchResults(res);
-    }
-    else if (g_view == ViewKind::Drives)
-    {
-        ShowDrives();
-    }
+    Rows_PathChanged(oldPath, newPath);
+    SearchResults_Apply({ { oldPath, newPath } });
 }
 
 // ----------------------------- Playback / post actions
 
-static void ApplyPostActionsAndRefresh()
+// CopyFileExW progress for a job: byte progress, pause, cancel and the
+// playback I/O budget
+struct JobCopyCtx
 {
-    for (size_t i = 0; i < g_post.size(); ++i)
+    Job* job;
+    IoSlot* slot;       // given up while the job is paused
+    ULONGLONG reported;
+};
+
+static DWORD CALLBACK JobCopyProgress(LARGE_INTEGER total, LARGE_INTEGER transferred,
+                                      LARGE_INTEGER, LARGE_INTEGER,
+                                      DWORD, DWORD, HANDLE, HANDLE, LPVOID lpData)
+{
+    JobCopyCtx* ctx = reinterpret_cast<JobCopyCtx*>(lpData);
+    Job* job = ctx->job;
+    ULONGLONG all = (ULONGLONG)total.QuadPart, done = (ULONGLONG)transferred.QuadPart;
+    job->SetDetail(FormatSize(done) + L" of " + FormatSize(all),
+                   all ? (int)(done * 1000 / all) : 1000);
+    if (done > ctx->reported)
+    {
+        IoGovernor_Throttle((double)(done - ctx->reported), &job->cancel);
+        ctx->reported = done;
+    }
+    if (!ctx->slot->Checkpoint()) return PROGRESS_CANCEL;
+    return job->Cancelled() ? PROGRESS_CANCEL : PROGRESS_CONTINUE;
+}
+
+// The player may hold a file it just let go of for a moment longer
+static bool RetryWhileShared(Job& owner, const std::function<BOOL()>& op)
+{
+    for (int tries = 0; ; ++tries)
     {
-        const PostAction& a = g_post[i];
+        if (op()) return true;
+        if (GetLastError() != ERROR_SHARING_VIOLATION || tries >= 10 || owner.Cancelled())
+            return false;
+        Sleep(500);
+    }
+}
+
+// The actions queued during playback, in order; runs on a job thread
+static bool RunPostActionsJob(Job& owner, const std::vector<PostAction>& actions)
+{
+    bool allOk = true;
+    bool background = false;
+    for (size_t i = 0; i < actions.size(); ++i)
+    {
+        if (!owner.WaitWhilePaused())
+        {
+            allOk = false;
+            break;
+        }
+        IoGovernor_ThreadMode(background);
+        const PostAction& a = actions[i];
+        wchar_t buf[MAX_PATH + 64];
+        swprintf_s(buf, L"%zu of %zu: %s", i + 1, actions.size(), PathFindFileNameW(a.src.c_str()));
+        owner.SetStatus(buf);
+        owner.SetDetail(L"", -1);
+
+        // Queue behind other jobs on the same disks, like any other transfer
+        IoSlot slot(IoDeviceForPath(a.src), a.param.empty() ? nullptr : IoDeviceForPath(a.param),
+                    &owner.cancel);
+        if (!slot.ok)
+        {
+            allOk = false;
+            break;
+        }
+        slot.paused = &owner.paused;
+
         switch (a.type)
         {
         case ActionType::DeleteFile:
         {
-            BOOL ok = DeleteFileW(a.src.c_str());
+            BOOL ok = RetryWhileShared(owner, [&a]()
+            {
+                return DeleteFileW(a.src.c_str());
+            });
             if (!ok)
             {
                 DWORD err = GetLastError();
                 MoveFileExW(a.src.c_str(), NULL, MOVEFILE_DELAY_UNTIL_REBOOT);
                 LogLine(L"PostAction DeleteFile: src=\"%s\" FAILED err=%lu (queued delete)",
                         a.src.c_str(), err);
+                allOk = false;
             }
             else
             {
@@ -2761,44 +8093,155 @@ static void ApplyPostActionsAndRefresh()
         }
         case ActionType::RenameFile:
         {
-            BOOL ok = MoveFileExW(
-                          a.src.c_str(), a.param.c_str(),
-                          MOVEFILE_COPY_ALLOWED | MOVEFILE_REPLACE_EXISTING);
+            BOOL ok = RetryWhileShared(owner, [&a]()
+            {
+                return MoveFileExW(a.src.c_str(), a.param.c_str(),
+                                   MOVEFILE_COPY_ALLOWED | MOVEFILE_REPLACE_EXISTING);
+            });
             DWORD err = ok ? 0 : GetLastError();
             LogLine(L"PostAction RenameFile: src=\"%s\" dst=\"%s\" %s err=%lu",
                     a.src.c_str(), a.param.c_str(), ok ? L"OK" : L"FAILED", err);
+            if (!ok) allOk = false;
             break;
         }
         case ActionType::CopyToPath:
         {
-            std::wstring t = L"Browse - copying file...";
-            SetWindowTextW(g_hwndMain, t.c_str());
-            BOOL ok = CopyFileW(a.src.c_str(), a.param.c_str(), FALSE);
+            // Same block-cloning volume: clone unless the destination exists
+            // (the copy below overwrites it).
+            BOOL ok = FALSE, cloned = FALSE;
+            WIN32_FILE_ATTRIBUTE_DATA fad{};
+            if (GetFileAttributesExW(a.src.c_str(), GetFileExInfoStandard, &fad) &&
+                    GetFileAttributesW(a.param.c_str()) == INVALID_FILE_ATTRIBUTES &&
+                    SameVolume(a.src, a.param) && VolumeSupportsBlockClone(a.param))
+            {
+                ULARGE_INTEGER uli;
+                uli.HighPart = fad.nFileSizeHigh;
+                uli.LowPart = fad.nFileSizeLow;
+                ok = cloned = CloneFileBlocks(a.src, a.param, uli.QuadPart,
+                                              fad.ftLastWriteTime, fad.dwFileAttributes) == 0;
+            }
+            JobCopyCtx ctx = { &owner, &slot, 0 };
+            if (!ok) ok = CopyFileExW(a.src.c_str(), a.param.c_str(), JobCopyProgress, &ctx, NULL, 0);
             DWORD err = ok ? 0 : GetLastError();
-            LogLine(L"PostAction CopyToPath: src=\"%s\" dst=\"%s\" %s err=%lu",
-                    a.src.c_str(), a.param.c_str(), ok ? L"OK" : L"FAILED", err);
+            LogLine(L"PostAction CopyToPath: src=\"%s\" dst=\"%s\" %s%s err=%lu",
+                    a.src.c_str(), a.param.c_str(), ok ? L"OK" : L"FAILED",
+                    cloned ? L" (cloned)" : L"", err);
+            if (!ok) allOk = false;
             break;
         }
         }
     }
-    g_post.clear();
+    if (background) SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_END);
+    owner.SetDetail(L"", -1);
+    owner.SetStatus(allOk ? L"Done" : L"Some actions failed (see browse.log)");
+    return allOk;
+}
+
+// ----------------------------- Post-playback actions
+//
+// Actions queued in playback run as jobs as soon as they can: a copy starts
+// right away (throttled while the video plays), a delete or rename waits
+// until its file is no longer the one playing. Actions on the same file keep
+// their order. g_post holds each action until its job ends.
+
+static bool PostAction_Touches(const PostAction& a, const std::wstring& path)
+{
+    return _wcsicmp(a.src.c_str(), path.c_str()) == 0 ||
+           (!a.param.empty() && _wcsicmp(a.param.c_str(), path.c_str()) == 0);
+}
+
+static bool PostAction_Ready(size_t i)
+{
+    const PostAction& a = g_post[i];
+    if (a.type != ActionType::CopyToPath && g_inPlayback && g_playlistIndex < g_playlist.size() &&
+            _wcsicmp(g_playlist[g_playlistIndex].c_str(), a.src.c_str()) == 0)
+        return false; // still open in the player
+
+    for (size_t k = 0; k < i; ++k)
+    {
+        if (PostAction_Touches(g_post[k], a.src) ||
+                (!a.param.empty() && PostAction_Touches(g_post[k], a.param)))
+            return false;
+    }
+    return true;
+}
 
-    if (g_view == ViewKind::Search && g_search.active)
+static std::wstring PostAction_Title(const PostAction& a)
+{
+    const wchar_t* name = PathFindFileNameW(a.src.c_str());
+    switch (a.type)
     {
-        std::vector<Row> res;
-        RunSearchFromOrigin(res);
-        ShowSearchResults(res);
+    case ActionType::DeleteFile: return L"Delete \"" + std::wstring(name) + L"\"";
+    case ActionType::RenameFile: return L"Rename \"" + std::wstring(name) + L"\" to \"" +
+                                            PathFindFileNameW(a.param.c_str()) + L"\"";
+    case ActionType::CopyToPath: return L"Copy \"" + std::wstring(name) + L"\" to " + ParentDir(a.param);
     }
-    else if (g_view == ViewKind::Drives)
+    return name;
+}
+
+static void PostActions_Pump();
+
+static void PostActions_Finished(Job& j, const PostAction& a)
+{
+    g_post.erase(std::remove_if(g_post.begin(), g_post.end(), [&j](const PostAction& p)
     {
-        ShowDrives();
+        return p.job == j.id;
+    }), g_post.end());
+
+    if (j.state.load() == JobState::Done)
+    {
+        if (a.type == ActionType::DeleteFile)
+        {
+            Rows_PathChanged(a.src, L"");
+            SearchResults_Apply({ { a.src, L"" } });
+        }
+        else if (a.type == ActionType::RenameFile)
+        {
+            Rows_PathChanged(a.src, a.param);
+            SearchResults_Apply({ { a.src, a.param } });
+            for (auto& p : g_playlist)
+                if (_wcsicmp(p.c_str(), a.src.c_str()) == 0) p = a.param;
+        }
+        else if (a.type == ActionType::CopyToPath)
+        {
+            SearchResults_Apply({ { L"", a.param } });
+        }
     }
-    else
+    PostActions_Pump(); // later actions on the same file may go now
+}
+
+// Start every queued action that can run now. Called when an action is
+// queued, when the player moves to another file, on exit from playback and
+// when an action ends.
+static void PostActions_Pump()
+{
+    for (size_t i = 0; i < g_post.size(); ++i)
     {
-        ShowFolder(g_folder);
+        if (g_post[i].job || !PostAction_Ready(i)) continue;
+
+        const PostAction a = g_post[i];
+        auto job = std::make_shared<Job>();
+        job->title = PostAction_Title(a);
+        if (a.type == ActionType::CopyToPath) job->touched.push_back(ParentDir(a.param));
+        job->run = [a](Job& j)
+        {
+            return RunPostActionsJob(j, std::vector<PostAction>{ a });
+        };
+        job->finished = [a](Job& j)
+        {
+            PostActions_Finished(j, a);
+        };
+        Jobs_Add(job);
+        g_post[i].job = job->id;
     }
 }
 
+static void PostActions_Queue(ActionType type, const std::wstring& src, const std::wstring& param)
+{
+    g_post.push_back({ type, src, param });
+    PostActions_Pump();
+}
+
 static void PlayIndex(size_t idx)
 {
     if (!g_vlc)
@@ -2816,6 +8259,11 @@ static void PlayIndex(size_t idx)
         {
             PostMessageW(g_hwndMain, WM_APP + 1, 0, 0);
         }, NULL);
+        libvlc_event_attach(em, libvlc_MediaPlayerBuffering,
+                            [](const libvlc_event_t* e, void*)
+        {
+            IoGovernor_OnBuffering(e->u.media_player_buffering.new_cache);
+        }, NULL);
     }
 
     g_playlistIndex = idx;
@@ -2828,6 +8276,9 @@ static void PlayIndex(size_t idx)
     libvlc_media_player_set_media(g_mp, m);
     libvlc_media_release(m);
     libvlc_media_player_play(g_mp);
+
+    // The previous file may be free for its queued rename or delete now
+    PostActions_Pump();
 }
 
 static void ToggleFullscreen()
@@ -2877,14 +8328,18 @@ static void ExitPlayback()
     ShowWindow(g_hwndVideo, SW_HIDE);
     ShowWindow(g_hwndSeek, SW_HIDE);
     ShowWindow(g_hwndList, SW_SHOW);
+    if (g_filterShown) ShowWindow(g_hwndFilter, SW_SHOW);
     SetFocus(g_hwndList);
     g_inPlayback = false;
+    IoGovernor_SetPlayback(false);
 
-    RECT rc;
-    GetClientRect(g_hwndMain, &rc);
-    MoveWindow(g_hwndList, 0, 0, rc.right, rc.bottom, TRUE);
+    LayoutMain();
 
-    ApplyPostActionsAndRefresh();
+    // Nothing is open any more: queued renames and deletes can go. The view
+    // is patched as each action ends.
+    PostActions_Pump();
+    if (g_jobsStaleView && g_view == ViewKind::Folder) ShowFolder(g_folder);
+    g_jobsStaleView = false;
     SetTitleFolderOrDrives();
     LogLine(L"ExitPlayback finished");
 }
@@ -2907,16 +8362,15 @@ static void PlaySelectedVideos()
     int idx = -1;
     while ((idx = ListView_GetNextItem(g_hwndList, idx, LVNI_SELECTED)) != -1)
     {
-        if (idx >= 0 && idx < (int)g_rows.size())
-        {
-            const Row& it = g_rows[idx];
-            if (!it.isDir && IsVideoFile(it.full)) g_playlist.push_back(it.full);
-        }
+        const Row* it = RowAt(idx);
+        if (it && !it->isDir && IsVideoFile(it->full)) g_playlist.push_back(it->full);
     }
     if (g_playlist.empty()) return;
 
     g_inPlayback = true;
+    IoGovernor_SetPlayback(true);
     ShowWindow(g_hwndList, SW_HIDE);
+    if (g_filterShown) ShowWindow(g_hwndFilter, SW_HIDE);
     ShowWindow(g_hwndSeek, SW_SHOW);
     ShowWindow(g_hwndVideo, SW_SHOW);
     SetFocus(g_hwndVideo);
@@ -2938,9 +8392,9 @@ static void PlaySelectedVideos()
 
 static void ActivateSelection()
 {
-    int i = ListView_GetNextItem(g_hwndList, -1, LVNI_SELECTED);
-    if (i < 0 || i >= (int)g_rows.size()) return;
-    const Row& r = g_rows[i];
+    const Row* sel = RowAt(ListView_GetNextItem(g_hwndList, -1, LVNI_SELECTED));
+    if (!sel) return;
+    const Row& r = *sel;
 
     // NEW: drives view broken-drive block
     if (g_view == ViewKind::Drives && r.isBrokenNetDrive)
@@ -2953,7 +8407,12 @@ static void ActivateSelection()
     if (g_view == ViewKind::Drives || r.isDir)
     {
         if (g_view == ViewKind::Search) return;
-        ShowFolder(r.full);
+        // Going down the way Left came up keeps the way further down
+        if (!g_navForward.empty() && _wcsicmp(EnsureSlash(r.full).c_str(), g_navForward.back().c_str()) == 0)
+            g_navForward.pop_back();
+        else
+            g_navForward.clear();
+        OpenFolder(r.full);
     }
     else
     {
@@ -2976,6 +8435,8 @@ static void NavigateBack()
         return;
     }
     if (g_view == ViewKind::Drives) return;
+    g_navForward.push_back(EnsureSlash(g_folder));
+    if (g_navForward.size() > kNavForwardMax) g_navForward.erase(g_navForward.begin());
     if (IsDriveRoot(g_folder))
     {
         ShowDrives();
@@ -2983,7 +8444,22 @@ static void NavigateBack()
     }
     std::wstring parent = ParentDir(g_folder);
     if (parent.empty()) ShowDrives();
-    else ShowFolder(parent);
+    else OpenFolder(parent);
+}
+
+// Back down into the folder Left last came up from
+static void NavigateForward()
+{
+    if (g_view == ViewKind::Search || g_navForward.empty()) return;
+    const std::wstring here = (g_view == ViewKind::Drives) ? std::wstring() : EnsureSlash(g_folder);
+    if (_wcsicmp(ParentDir(g_navForward.back()).c_str(), here.c_str()) != 0)
+    {
+        g_navForward.clear(); // we went elsewhere since
+        return;
+    }
+    std::wstring next = g_navForward.back();
+    g_navForward.pop_back();
+    OpenFolder(next);
 }
 
 // ----------------------------- Playlist chooser
@@ -3102,6 +8578,9 @@ static LRESULT CALLBACK ListSubclass(HWND h, UINT m, WPARAM w, LPARAM l,
         case VK_BACK:
             NavigateBack();
             return 0;
+        case VK_RIGHT:
+            NavigateForward();
+            return 0;
         case VK_F1:
             ShowHelp();
             return 0;
@@ -3112,11 +8591,8 @@ static LRESULT CALLBACK ListSubclass(HWND h, UINT m, WPARAM w, LPARAM l,
         case 'A':
             if (ctrl)
             {
-                for (int i = 0; i < (int)g_rows.size(); ++i)
-                {
-                    ListView_SetItemState(g_hwndList, i,
-                                          LVIS_SELECTED, LVIS_SELECTED);
-                }
+                ListView_SetItemState(g_hwndList, -1,
+                                      LVIS_SELECTED, LVIS_SELECTED);
                 return 0;
             }
             break;
@@ -3129,53 +8605,35 @@ static LRESULT CALLBACK ListSubclass(HWND h, UINT m, WPARAM w, LPARAM l,
             }
             break;
 
-        case 'F':
+        case 'E':
             if (ctrl)
             {
-                std::wstring kw;
-                if (!PromptKeyword(kw)) return 0;
-                kw = ToLower(kw);
-                if (kw.empty()) return 0;
+                QuickFilter_Show();
+                return 0;
+            }
+            break;
 
-                if (g_view != ViewKind::Search)
-                {
-                    g_search.active = true;
-                    g_search.originView = g_view;
-                    g_search.originFolder =
-                        (g_view == ViewKind::Folder ? g_folder : L"");
-                    g_search.termsLower.clear();
-                    g_search.termsLower.push_back(kw);
-
-                    g_search.useExplicitScope = false;
-                    g_search.explicitFolders.clear();
-                    g_search.explicitFiles.clear();
-
-                    std::vector<std::wstring> selFolders, selFiles;
-                    CollectSelection(selFolders, selFiles);
-                    if (!selFolders.empty() || !selFiles.empty())
-                    {
-                        g_search.useExplicitScope = true;
-                        g_search.explicitFolders.swap(selFolders);
-                        g_search.explicitFiles.swap(selFiles);
-                    }
+        case VK_ESCAPE:
+            if (!g_filterLower.empty())
+            {
+                QuickFilter_Clear();
+                SetTitleFolderOrDrives();
+                return 0;
+            }
+            break;
 
-                    std::vector<Row> res;
-                    RunSearchFromOrigin(res);
-                    ShowSearchResults(res);
-                }
-                else
-                {
-                    g_search.termsLower.push_back(kw);
-                    std::vector<Row> filtered;
-                    filtered.reserve(g_rows.size());
-                    for (size_t i = 0; i < g_rows.size(); ++i)
-                    {
-                        if (NameContainsAllTerms(g_rows[i].full,
-                                                 g_search.termsLower))
-                            filtered.push_back(g_rows[i]);
-                    }
-                    ShowSearchResults(filtered);
-                }
+        case 'F':
+            if (ctrl)
+            {
+                RunLiveSearch();
+                return 0;
+            }
+            break;
+
+        case 'J':
+            if (ctrl)
+            {
+                JobsPanel_Toggle();
                 return 0;
             }
             break;
@@ -3264,7 +8722,7 @@ static LRESULT CALLBACK VideoSubclass(HWND h, UINT m, WPARAM w, LPARAM l,
                 for (size_t i = 0; i < g_playlist.size(); ++i)
                     if (i != g_playlistIndex) np.push_back(g_playlist[i]);
                 g_playlist.swap(np);
-                g_post.push_back({ ActionType::DeleteFile, doomed, L"" });
+                g_post.push_back({ ActionType::DeleteFile, doomed, L"" }); // PlayIndex/ExitPlayback start it
                 if (g_playlist.empty()) ExitPlayback();
                 else if (g_playlistIndex >= g_playlist.size())
                     PlayIndex(g_playlist.size() - 1);
@@ -3283,7 +8741,7 @@ static LRESULT CALLBACK VideoSubclass(HWND h, UINT m, WPARAM w, LPARAM l,
                 if (PromptSaveAsFrom(cur, newPath, L"Rename file"))
                 {
                     if (_wcsicmp(cur.c_str(), newPath.c_str()) != 0)
-                        g_post.push_back({ ActionType::RenameFile, cur, newPath });
+                        PostActions_Queue(ActionType::RenameFile, cur, newPath);
                 }
                 libvlc_media_player_set_pause(g_mp, 0);
                 return 0;
@@ -3299,7 +8757,7 @@ static LRESULT CALLBACK VideoSubclass(HWND h, UINT m, WPARAM w, LPARAM l,
                 if (PromptSaveAsFrom(cur, destFull, L"Copy file to"))
                 {
                     if (_wcsicmp(cur.c_str(), destFull.c_str()) != 0)
-                        g_post.push_back({ ActionType::CopyToPath, cur, destFull });
+                        PostActions_Queue(ActionType::CopyToPath, cur, destFull);
                 }
                 libvlc_media_player_set_pause(g_mp, 0);
                 return 0;
@@ -3414,7 +8872,13 @@ static void OnSize(int cx, int cy)
     }
     else
     {
-        if (g_hwndList)  MoveWindow(g_hwndList, 0, 0, cx, cy, TRUE);
+        int top = 0;
+        if (g_filterShown && g_hwndFilter)
+        {
+            top = DpiScale(26);
+            MoveWindow(g_hwndFilter, 0, 0, cx, top, TRUE);
+        }
+        if (g_hwndList)  MoveWindow(g_hwndList, 0, top, cx, cy - top, TRUE);
     }
 }
 
@@ -3600,10 +9064,10 @@ static bool GetSelectedDriveLetter(wchar_t& outLetter)
     outLetter = 0;
     if (g_view != ViewKind::Drives) return false;
 
-    int sel = ListView_GetNextItem(g_hwndList, -1, LVNI_SELECTED);
-    if (sel < 0 || sel >= (int)g_rows.size()) return false;
+    const Row* sel = RowAt(ListView_GetNextItem(g_hwndList, -1, LVNI_SELECTED));
+    if (!sel) return false;
 
-    const Row& r = g_rows[sel];
+    const Row& r = *sel;
     if (!r.full.empty()) outLetter = (wchar_t)towupper(r.full[0]);
     else if (!r.name.empty()) outLetter = (wchar_t)towupper(r.name[0]);
 
@@ -3848,9 +9312,9 @@ static void ShowListContextMenu(POINT ptScreen)
     bool onItem = (idx >= 0) && (hti.flags & LVHT_ONITEM);
 
     // Special-case: broken mapped drive in Drives view => only "Fix"
-    if (onItem && g_view == ViewKind::Drives)
+    if (onItem && g_view == ViewKind::Drives && RowAt(idx))
     {
-        const Row& r = g_rows[idx];
+        const Row& r = *RowAt(idx);
         if (r.isBrokenNetDrive)
         {
             HMENU hMenu = CreatePopupMenu();
@@ -3898,9 +9362,9 @@ static void ShowListContextMenu(POINT ptScreen)
         pasteFlags = 0;
     }
 
-    if (onItem)
+    if (onItem && RowAt(idx))
     {
-        const Row& r = g_rows[idx];
+        const Row& r = *RowAt(idx);
         AppendMenuW(hMenu, MF_STRING, ID_CTX_OPEN, L"&Open");
         if (!r.isDir && IsVideoFile(r.full))
         {
@@ -3979,14 +9443,19 @@ LRESULT CALLBACK WndProc(HWND h, UINT m, WPARAM w, LPARAM l)
         g_hwndMain = h;
         INITCOMMONCONTROLSEX icc;
         icc.dwSize = sizeof(icc);
-        icc.dwICC = ICC_LISTVIEW_CLASSES | ICC_BAR_CLASSES;
+        icc.dwICC = ICC_LISTVIEW_CLASSES | ICC_BAR_CLASSES | ICC_PROGRESS_CLASS;
         InitCommonControlsEx(&icc);
 
         InitializeCriticalSection(&g_metaLock);
+        InitializeCriticalSection(&g_ioLock);
+        InitializeCriticalSection(&g_govLock);
+        InitializeConditionVariable(&g_ioCv);
+        Trash_Start();
 
         g_hwndList = CreateWindowExW(
                          WS_EX_CLIENTEDGE, WC_LISTVIEWW, L"",
-                         WS_CHILD | WS_VISIBLE | LVS_REPORT | LVS_SHOWSELALWAYS,
+                         WS_CHILD | WS_VISIBLE | LVS_REPORT | LVS_SHOWSELALWAYS |
+                         LVS_OWNERDATA,
                          0, 0, 100, 100, h, (HMENU)1001, g_hInst, NULL);
         ListView_SetExtendedListViewStyle(
             g_hwndList,
@@ -3995,6 +9464,16 @@ LRESULT CALLBACK WndProc(HWND h, UINT m, WPARAM w, LPARAM l)
         LV_ResetColumns();
         SetWindowSubclass(g_hwndList, ListSubclass, 1, 0);
 
+        g_hwndFilter = CreateWindowExW(
+                           WS_EX_CLIENTEDGE, L"EDIT", L"",
+                           WS_CHILD | ES_AUTOHSCROLL,
+                           0, 0, 100, 24, h, (HMENU)1004, g_hInst, NULL);
+        SendMessageW(g_hwndFilter, WM_SETFONT,
+                     (WPARAM)GetStockObject(DEFAULT_GUI_FONT), TRUE);
+        SendMessageW(g_hwndFilter, EM_SETCUEBANNER, TRUE,
+                     (LPARAM)L"Filter this folder (Esc clears)");
+        SetWindowSubclass(g_hwndFilter, FilterEditSub, 4, 0);
+
         g_hwndVideo = CreateWindowExW(
                           0, L"STATIC", L"",
                           WS_CHILD | WS_CLIPSIBLINGS | WS_CLIPCHILDREN,
@@ -4017,7 +9496,7 @@ LRESULT CALLBACK WndProc(HWND h, UINT m, WPARAM w, LPARAM l)
             {
                 if (attrs & FILE_ATTRIBUTE_DIRECTORY)
                 {
-                    ShowFolder(g_initialPath);
+                    OpenFolder(g_initialPath);
                 }
                 else
                 {
@@ -4050,6 +9529,14 @@ LRESULT CALLBACK WndProc(HWND h, UINT m, WPARAM w, LPARAM l)
         else SetFocus(g_hwndList);
         return 0;
 
+    case WM_COMMAND:
+        if ((HWND)l == g_hwndFilter && HIWORD(w) == EN_CHANGE)
+        {
+            QuickFilter_Apply();
+            return 0;
+        }
+        break;
+
     case WM_NOTIFY:
     {
         LPNMHDR nm = (LPNMHDR)l;
@@ -4059,11 +9546,27 @@ LRESULT CALLBACK WndProc(HWND h, UINT m, WPARAM w, LPARAM l)
             {
                 return HandleListCustomDraw((NMLVCUSTOMDRAW*)l);
             }
+            if (nm->code == LVN_GETDISPINFOW)
+            {
+                HandleListGetDispInfo((NMLVDISPINFOW*)l);
+                return 0;
+            }
+            if (nm->code == LVN_ODFINDITEMW)
+            {
+                return HandleListFindItem((NMLVFINDITEMW*)l);
+            }
             if (nm->code == LVN_ITEMACTIVATE)
             {
                 ActivateSelection();
                 return 0;
             }
+            if (nm->code == LVN_ITEMCHANGED)
+            {
+                const NMLISTVIEW* p = (const NMLISTVIEW*)l;
+                if ((p->uChanged & LVIF_STATE) && (p->uNewState & ~p->uOldState & LVIS_FOCUSED))
+                    Prefetch_OnFocusChanged(h);
+                return 0;
+            }
             if (nm->code == LVN_COLUMNCLICK)
             {
                 if (g_view == ViewKind::Drives)
@@ -4105,6 +9608,17 @@ LRESULT CALLBACK WndProc(HWND h, UINT m, WPARAM w, LPARAM l)
         break;
 
     case WM_TIMER:
+        if (w == kTimerPrefetch)
+        {
+            KillTimer(h, kTimerPrefetch);
+            Prefetch_Start();
+            return 0;
+        }
+        if (w == kTimerDriveProbe)
+        {
+            Drives_OnProbeTimeout();
+            return 0;
+        }
         if (w == kTimerPlaybackUI && g_inPlayback && g_mp)
         {
             libvlc_time_t len = libvlc_media_player_get_length(g_mp);
@@ -4180,6 +9694,43 @@ LRESULT CALLBACK WndProc(HWND h, UINT m, WPARAM w, LPARAM l)
             ExitPlayback();
         return 0;
 
+    case WM_APP_JOB:
+        Jobs_OnFinished((int)w);
+        return 0;
+
+    case WM_APP_DRIVEPROBE:
+    {
+        DriveProbe* dp = (DriveProbe*)l;
+        if (dp) Drives_OnProbe(*dp);
+        delete dp;
+        return 0;
+    }
+
+    case WM_APP_RECRAWL:
+    {
+        SearchRecrawl* rc = (SearchRecrawl*)l;
+        if (rc) SearchResults_OnRecrawl(*rc);
+        delete rc;
+        return 0;
+    }
+
+    case WM_APP_NAVLIST:
+    {
+        NavListing* nl = (NavListing*)l;
+        if (nl) NavCache_OnListing(*nl);
+        delete nl;
+        return 0;
+    }
+
+    case WM_APP_FSCHANGE:
+    {
+        FsChangeBatch* b = (FsChangeBatch*)l;
+        if (b && (unsigned)w == g_watchGen && g_view == ViewKind::Folder && !g_loadingFolder)
+            FolderWatch_Apply(*b);
+        delete b;
+        return 0;
+    }
+
     case WM_APP_META:
     {
         MetaResult* r = (MetaResult*)l;
@@ -4195,21 +9746,18 @@ LRESULT CALLBACK WndProc(HWND h, UINT m, WPARAM w, LPARAM l)
                         it.vW = r->w;
                         it.vH = r->h;
                         it.vDur100ns = r->dur;
-                        if (!it.isDir && IsVideoFile(it.full))
+                        if (it.snapIdx >= 0 && it.snapIdx < (int)g_searchSnap.rows.size())
                         {
-                            if (it.vW > 0 && it.vH > 0)
+                            Row& snap = g_searchSnap.rows[it.snapIdx];
+                            if (snap.full == it.full)
                             {
-                                wchar_t buf[64];
-                                swprintf_s(buf, L"%dx%d", it.vW, it.vH);
-                                ListView_SetItemText(g_hwndList, i, 4, buf);
-                            }
-                            if (it.vDur100ns > 0)
-                            {
-                                std::wstring ds = FormatDuration100ns(it.vDur100ns);
-                                ListView_SetItemText(g_hwndList, i, 5,
-                                                     const_cast<wchar_t*>(ds.c_str()));
+                                snap.vW = it.vW;
+                                snap.vH = it.vH;
+                                snap.vDur100ns = it.vDur100ns;
                             }
                         }
+                        int item = ItemForRow(i);
+                        if (item >= 0) ListView_RedrawItems(g_hwndList, item, item);
                         break;
                     }
                 }
@@ -4225,11 +9773,20 @@ LRESULT CALLBACK WndProc(HWND h, UINT m, WPARAM w, LPARAM l)
             MessageBoxW(h, L"Loading folder... please wait.", L"Browse", MB_OK);
             return 0;
         }
+        if (Jobs_ActiveCount())
+        {
+            wchar_t msg[160];
+            swprintf_s(msg, L"%zu job(s) are still running or queued.\n\n"
+                       L"Cancel them and exit? (Pastes can be resumed later.)", Jobs_ActiveCount());
+            if (MessageBoxW(h, msg, L"Browse", MB_YESNO | MB_ICONQUESTION) != IDYES) return 0;
+        }
         DestroyWindow(h);
         return 0;
 
     case WM_DESTROY:
         KillTimer(h, kTimerPlaybackUI);
+        Jobs_Shutdown();
+        FolderWatch_Stop();
 
         CancelMetaWorkAndClearTodo();
         if (g_metaThread)
@@ -4320,6 +9877,8 @@ int APIENTRY wWinMain(HINSTANCE hInst, HINSTANCE, LPWSTR, int nShow)
         TranslateMessage(&msg);
         DispatchMessageW(&msg);
     }
+    // Job threads still running use g_cfg and their jobs: skip static teardown
+    if (g_jobsStuck) ExitProcess(0);
     CoUninitialize();
     return 0;
 }
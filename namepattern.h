@@ -0,0 +1,729 @@
+// namepattern.h - glob / regex name matching for Browse's search (lazy DFA)
+//
+// Plain C++17, no Win32: browse.cpp uses it for the Glob and Regex search
+// modes and tests/namepattern_test.cpp checks it on any platform.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cwchar>
+#include <cwctype>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Regex subset: literals, . [..] [^..] with ranges, \d \w \s \D \W \S and
+// escaped punctuation, ( ) (?: ) | * + ? {m} {m,} {m,n}, ^ $. A glob is
+// rewritten to an anchored regex (* ? [..] [!..]). Matching is against
+// lower-cased names, so literals are lower-cased at compile time.
+//
+// The pattern becomes a Thompson NFA; DFA states (sets of NFA states) are
+// built the first time a transition is needed and then reused, so each name
+// is matched in one left-to-right pass. A literal that every match must
+// contain is checked first with a plain find().
+struct NamePattern
+{
+    struct Node
+    {
+        enum Kind { Empty, Set, Concat, Alt, Repeat, Bol, Eol } kind = Empty;
+        int set = -1;            // Set: index into sets
+        wchar_t lit = 0;         // Set: the single literal char, if it is one
+        std::vector<int> kids;   // Concat / Alt / Repeat (one kid)
+        int minRep = 0, maxRep = 0; // Repeat; maxRep < 0 = unbounded
+    };
+    struct CharSet
+    {
+        std::vector<std::pair<uint32_t, uint32_t>> ranges; // inclusive
+        bool negate = false;
+    };
+    struct NfaState
+    {
+        enum Op { Set, Split, Bol, Eol, Match } op = Split;
+        int set = -1;
+        int out = -1, out1 = -1;
+    };
+    struct DfaState
+    {
+        std::vector<int> nfa;    // sorted NFA states after closure
+        std::vector<int> next;   // per char class, -1 = not built yet
+        bool acceptNow = false;  // a match ends here
+        bool acceptEnd = false;  // a match ends here if this is the end of the name
+        bool dead = false;       // nothing can match from here
+    };
+
+    static const int kMaxNfaStates = 20000;
+    static const int kMaxDfaStates = 2000;   // cache is flushed beyond this
+
+    bool valid = false;
+    std::wstring literal;        // prefilter: every match contains this
+
+    std::vector<Node> nodes;
+    std::vector<CharSet> sets;
+    std::vector<NfaState> nfa;
+    int nfaStart = -1;
+
+    std::vector<uint32_t> points;     // char class boundaries
+    uint16_t asciiClass[128] = {};
+    std::vector<std::vector<char>> classIn; // [set][class]
+    int numClasses = 1;
+
+    std::vector<DfaState> dfa;        // dfa[0] is the start state
+    std::map<std::vector<int>, int> dfaIndex;
+    std::vector<unsigned> mark;
+    unsigned markGen = 0;
+
+    // --- parser
+
+    const wchar_t* p = nullptr;
+    const wchar_t* pend = nullptr;
+    std::wstring err;
+
+    int NewNode(Node::Kind k)
+    {
+        Node n;
+        n.kind = k;
+        nodes.push_back(n);
+        return (int)nodes.size() - 1;
+    }
+
+    int NewSetNode(const CharSet& cs, wchar_t lit)
+    {
+        sets.push_back(cs);
+        int n = NewNode(Node::Set);
+        nodes[n].set = (int)sets.size() - 1;
+        nodes[n].lit = lit;
+        return n;
+    }
+
+    int LiteralNode(wchar_t c)
+    {
+        c = (wchar_t)towlower(c);
+        CharSet cs;
+        cs.ranges.push_back(std::make_pair((uint32_t)c, (uint32_t)c));
+        return NewSetNode(cs, c);
+    }
+
+    static void AddRange(CharSet& cs, uint32_t lo, uint32_t hi)
+    {
+        cs.ranges.push_back(std::make_pair(lo, hi));
+        // names are lower-case: fold any A-Z part of the range
+        uint32_t a = std::max<uint32_t>(lo, L'A'), b = std::min<uint32_t>(hi, L'Z');
+        if (a <= b) cs.ranges.push_back(std::make_pair(a + 32, b + 32));
+    }
+
+    // \d \w \s (and upper-case negations); false if 'e' is not a class escape
+    static bool ClassEscape(wchar_t e, CharSet& cs, bool& negated)
+    {
+        negated = (e == L'D' || e == L'W' || e == L'S');
+        switch (towlower(e))
+        {
+        case L'd':
+            AddRange(cs, L'0', L'9');
+            return true;
+        case L'w':
+            AddRange(cs, L'0', L'9');
+            AddRange(cs, L'a', L'z');
+            AddRange(cs, L'_', L'_');
+            return true;
+        case L's':
+            AddRange(cs, L' ', L' ');
+            AddRange(cs, L'\t', L'\r');
+            return true;
+        }
+        return false;
+    }
+
+    bool ParseClass(int& outNode)
+    {
+        CharSet cs;
+        if (p < pend && *p == L'^')
+        {
+            cs.negate = true;
+            ++p;
+        }
+        bool first = true;
+        while (p < pend && (*p != L']' || first))
+        {
+            first = false;
+            uint32_t lo = *p++;
+            if (lo == L'\\' && p < pend)
+            {
+                bool neg = false;
+                CharSet esc;
+                if (ClassEscape(*p, esc, neg))
+                {
+                    if (neg)
+                    {
+                        err = L"negated class escape inside [..] is not supported";
+                        return false;
+                    }
+                    ++p;
+                    cs.ranges.insert(cs.ranges.end(), esc.ranges.begin(), esc.ranges.end());
+                    continue;
+                }
+                lo = *p++;
+            }
+            uint32_t hi = lo;
+            if (p + 1 < pend && *p == L'-' && p[1] != L']')
+            {
+                ++p;
+                hi = *p++;
+                if (hi == L'\\' && p < pend) hi = *p++;
+                if (hi < lo)
+                {
+                    err = L"bad range in [..]";
+                    return false;
+                }
+            }
+            AddRange(cs, lo, hi);
+        }
+        if (p >= pend)
+        {
+            err = L"missing ]";
+            return false;
+        }
+        ++p; // ]
+        outNode = NewSetNode(cs, 0);
+        return true;
+    }
+
+    bool ParseAtom(int& outNode)
+    {
+        wchar_t c = *p++;
+        switch (c)
+        {
+        case L'(':
+            if (p + 1 < pend && p[0] == L'?' && p[1] == L':') p += 2;
+            if (!ParseAlt(outNode)) return false;
+            if (p >= pend || *p != L')')
+            {
+                err = L"missing )";
+                return false;
+            }
+            ++p;
+            return true;
+        case L'[':
+            return ParseClass(outNode);
+        case L'.':
+        {
+            CharSet any;
+            any.negate = true;
+            outNode = NewSetNode(any, 0);
+            return true;
+        }
+        case L'^':
+            outNode = NewNode(Node::Bol);
+            return true;
+        case L'$':
+            outNode = NewNode(Node::Eol);
+            return true;
+        case L'*':
+        case L'+':
+        case L'?':
+            err = L"nothing to repeat";
+            return false;
+        case L'\\':
+        {
+            if (p >= pend)
+            {
+                err = L"trailing \\";
+                return false;
+            }
+            wchar_t e = *p++;
+            CharSet cs;
+            bool neg = false;
+            if (ClassEscape(e, cs, neg))
+            {
+                cs.negate = neg;
+                outNode = NewSetNode(cs, 0);
+                return true;
+            }
+            if (e == L't') e = L'\t';
+            outNode = LiteralNode(e);
+            return true;
+        }
+        }
+        outNode = LiteralNode(c);
+        return true;
+    }
+
+    // {m} {m,} {m,n}; leaves p alone if this is not a valid counted repeat
+    bool ParseCount(int& mn, int& mx)
+    {
+        const wchar_t* q = p + 1;
+        auto num = [&](int& v) -> bool
+        {
+            if (q >= pend || !iswdigit(*q)) return false;
+            v = 0;
+            while (q < pend && iswdigit(*q))
+            {
+                v = v * 10 + (*q++ - L'0');
+                if (v > 1000) return false;
+            }
+            return true;
+        };
+        if (!num(mn)) return false;
+        mx = mn;
+        if (q < pend && *q == L',')
+        {
+            ++q;
+            if (!num(mx)) mx = -1;
+        }
+        if (q >= pend || *q != L'}') return false;
+        if (mx >= 0 && mx < mn) return false;
+        p = q + 1;
+        return true;
+    }
+
+    bool ParseRepeat(int& outNode)
+    {
+        if (!ParseAtom(outNode)) return false;
+        while (p < pend)
+        {
+            int mn, mx;
+            if (*p == L'*') { mn = 0; mx = -1; ++p; }
+            else if (*p == L'+') { mn = 1; mx = -1; ++p; }
+            else if (*p == L'?') { mn = 0; mx = 1; ++p; }
+            else if (*p == L'{' && ParseCount(mn, mx)) {}
+            else break;
+            if (p < pend && *p == L'?') ++p; // lazy: same match/no-match answer
+
+            int r = NewNode(Node::Repeat);
+            nodes[r].kids.push_back(outNode);
+            nodes[r].minRep = mn;
+            nodes[r].maxRep = mx;
+            outNode = r;
+        }
+        return true;
+    }
+
+    bool ParseConcat(int& outNode)
+    {
+        outNode = NewNode(Node::Concat);
+        while (p < pend && *p != L'|' && *p != L')')
+        {
+            int kid;
+            if (!ParseRepeat(kid)) return false;
+            nodes[outNode].kids.push_back(kid);
+        }
+        return true;
+    }
+
+    bool ParseAlt(int& outNode)
+    {
+        int first;
+        if (!ParseConcat(first)) return false;
+        if (p >= pend || *p != L'|')
+        {
+            outNode = first;
+            return true;
+        }
+        outNode = NewNode(Node::Alt);
+        nodes[outNode].kids.push_back(first);
+        while (p < pend && *p == L'|')
+        {
+            ++p;
+            int kid;
+            if (!ParseConcat(kid)) return false;
+            nodes[outNode].kids.push_back(kid);
+        }
+        return true;
+    }
+
+    // Longest literal every match of node n must contain.
+    std::wstring RequiredLiteral(int n) const
+    {
+        const Node& nd = nodes[n];
+        switch (nd.kind)
+        {
+        case Node::Set:
+            return nd.lit ? std::wstring(1, nd.lit) : std::wstring();
+        case Node::Repeat:
+            return nd.minRep >= 1 ? RequiredLiteral(nd.kids[0]) : std::wstring();
+        case Node::Concat:
+        {
+            std::wstring best, run;
+            for (int k : nd.kids)
+            {
+                const Node& kn = nodes[k];
+                if (kn.kind == Node::Set && kn.lit)
+                {
+                    run.push_back(kn.lit);
+                    continue;
+                }
+                if (kn.kind == Node::Bol || kn.kind == Node::Eol) continue;
+                if (run.size() > best.size()) best = run;
+                run.clear();
+                std::wstring sub = RequiredLiteral(k);
+                if (sub.size() > best.size()) best = sub;
+            }
+            if (run.size() > best.size()) best = run;
+            return best;
+        }
+        default:
+            return std::wstring();
+        }
+    }
+
+    // --- NFA (Thompson construction)
+
+    struct Frag
+    {
+        int start;
+        std::vector<std::pair<int, int>> outs; // (state, 0 = out / 1 = out1)
+    };
+
+    int NewState(NfaState::Op op, int set = -1)
+    {
+        NfaState s;
+        s.op = op;
+        s.set = set;
+        nfa.push_back(s);
+        return (int)nfa.size() - 1;
+    }
+
+    void Patch(const std::vector<std::pair<int, int>>& outs, int target)
+    {
+        for (const auto& o : outs)
+        {
+            if (o.second == 0) nfa[o.first].out = target;
+            else nfa[o.first].out1 = target;
+        }
+    }
+
+    Frag Epsilon()
+    {
+        int s = NewState(NfaState::Split); // out1 stays -1
+        Frag f;
+        f.start = s;
+        f.outs.push_back(std::make_pair(s, 0));
+        return f;
+    }
+
+    bool Build(int n, Frag& f)
+    {
+        if ((int)nfa.size() > kMaxNfaStates)
+        {
+            err = L"pattern too large";
+            return false;
+        }
+        const Node& nd = nodes[n];
+        switch (nd.kind)
+        {
+        case Node::Empty:
+            f = Epsilon();
+            return true;
+        case Node::Set:
+        case Node::Bol:
+        case Node::Eol:
+        {
+            NfaState::Op op = nd.kind == Node::Set ? NfaState::Set
+                              : nd.kind == Node::Bol ? NfaState::Bol : NfaState::Eol;
+            int s = NewState(op, nd.set);
+            f.start = s;
+            f.outs.assign(1, std::make_pair(s, 0));
+            return true;
+        }
+        case Node::Concat:
+        {
+            if (nd.kids.empty())
+            {
+                f = Epsilon();
+                return true;
+            }
+            if (!Build(nd.kids[0], f)) return false;
+            for (size_t i = 1; i < nd.kids.size(); ++i)
+            {
+                Frag g;
+                if (!Build(nodes[n].kids[i], g)) return false;
+                Patch(f.outs, g.start);
+                f.outs.swap(g.outs);
+            }
+            return true;
+        }
+        case Node::Alt:
+        {
+            std::vector<int> kids = nd.kids;
+            if (!Build(kids.back(), f)) return false;
+            for (size_t i = kids.size() - 1; i-- > 0;)
+            {
+                Frag g;
+                if (!Build(kids[i], g)) return false;
+                int s = NewState(NfaState::Split);
+                nfa[s].out = g.start;
+                nfa[s].out1 = f.start;
+                f.start = s;
+                f.outs.insert(f.outs.end(), g.outs.begin(), g.outs.end());
+            }
+            return true;
+        }
+        case Node::Repeat:
+        {
+            const int kid = nd.kids[0], mn = nd.minRep, mx = nd.maxRep;
+            f = Epsilon();
+            for (int i = 0; i < mn; ++i)
+            {
+                Frag g;
+                if (!Build(kid, g)) return false;
+                Patch(f.outs, g.start);
+                f.outs.swap(g.outs);
+            }
+            if (mx < 0)
+            {
+                Frag g;
+                if (!Build(kid, g)) return false;
+                int s = NewState(NfaState::Split);
+                nfa[s].out = g.start;
+                Patch(g.outs, s);
+                Patch(f.outs, s);
+                f.outs.assign(1, std::make_pair(s, 1));
+            }
+            else
+            {
+                std::vector<std::pair<int, int>> skips;
+                for (int i = mn; i < mx; ++i)
+                {
+                    Frag g;
+                    if (!Build(kid, g)) return false;
+                    int s = NewState(NfaState::Split);
+                    nfa[s].out = g.start;
+                    Patch(f.outs, s);
+                    skips.push_back(std::make_pair(s, 1));
+                    f.outs.swap(g.outs);
+                }
+                f.outs.insert(f.outs.end(), skips.begin(), skips.end());
+            }
+            return true;
+        }
+        }
+        return false;
+    }
+
+    // --- lazy DFA
+
+    int ClassOf(wchar_t c) const
+    {
+        if ((unsigned)c < 128) return asciiClass[(unsigned)c];
+        return (int)(std::upper_bound(points.begin(), points.end(), (uint32_t)c) - points.begin());
+    }
+
+    void BuildClasses()
+    {
+        points.clear();
+        for (const auto& cs : sets)
+        {
+            for (const auto& r : cs.ranges)
+            {
+                points.push_back(r.first);
+                points.push_back(r.second + 1);
+            }
+        }
+        std::sort(points.begin(), points.end());
+        points.erase(std::unique(points.begin(), points.end()), points.end());
+        numClasses = (int)points.size() + 1;
+
+        for (unsigned c = 0; c < 128; ++c)
+        {
+            asciiClass[c] = (uint16_t)(std::upper_bound(points.begin(), points.end(), c) - points.begin());
+        }
+
+        classIn.assign(sets.size(), std::vector<char>(numClasses, 0));
+        for (size_t s = 0; s < sets.size(); ++s)
+        {
+            for (int k = 0; k < numClasses; ++k)
+            {
+                uint32_t rep = (k == 0) ? 0 : points[k - 1];
+                bool in = false;
+                for (const auto& r : sets[s].ranges)
+                {
+                    if (rep >= r.first && rep <= r.second)
+                    {
+                        in = true;
+                        break;
+                    }
+                }
+                classIn[s][k] = (char)(in != sets[s].negate);
+            }
+        }
+    }
+
+    // Follow epsilon edges; ^ only when atStart, $ only when atEnd.
+    void Closure(std::vector<int>& stack, bool atStart, bool atEnd, std::vector<int>& out)
+    {
+        out.clear();
+        if (++markGen == 0)
+        {
+            std::fill(mark.begin(), mark.end(), 0u);
+            markGen = 1;
+        }
+        while (!stack.empty())
+        {
+            int s = stack.back();
+            stack.pop_back();
+            if (s < 0 || mark[s] == markGen) continue;
+            mark[s] = markGen;
+            const NfaState& st = nfa[s];
+            if (st.op == NfaState::Split)
+            {
+                stack.push_back(st.out1);
+                stack.push_back(st.out);
+            }
+            else if ((st.op == NfaState::Bol && atStart) || (st.op == NfaState::Eol && atEnd))
+            {
+                stack.push_back(st.out);
+            }
+            else
+            {
+                out.push_back(s);
+            }
+        }
+        std::sort(out.begin(), out.end());
+    }
+
+    int Intern(std::vector<int>& set)
+    {
+        auto it = dfaIndex.find(set);
+        if (it != dfaIndex.end()) return it->second;
+
+        DfaState d;
+        d.nfa = set;
+        d.next.assign(numClasses, -1);
+        d.dead = true;
+        for (int s : set)
+        {
+            if (nfa[s].op == NfaState::Match) d.acceptNow = true;
+            if (nfa[s].op != NfaState::Bol) d.dead = false;
+        }
+        std::vector<int> stack(set.begin(), set.end()), endSet;
+        Closure(stack, false, true, endSet);
+        for (int s : endSet)
+            if (nfa[s].op == NfaState::Match) d.acceptEnd = true;
+
+        dfa.push_back(std::move(d));
+        int id = (int)dfa.size() - 1;
+        dfaIndex[set] = id;
+        return id;
+    }
+
+    void ResetDfa()
+    {
+        dfa.clear();
+        dfaIndex.clear();
+        std::vector<int> stack(1, nfaStart), set;
+        Closure(stack, true, false, set);
+        Intern(set);
+    }
+
+    int Next(int d, int cls)
+    {
+        int t = dfa[d].next[cls];
+        if (t >= 0) return t;
+
+        // Step over the char, then restart at the pattern start (unanchored search)
+        std::vector<int> stack, set;
+        stack.push_back(nfaStart);
+        for (int s : dfa[d].nfa)
+        {
+            const NfaState& st = nfa[s];
+            if (st.op == NfaState::Set && classIn[st.set][cls]) stack.push_back(st.out);
+        }
+        Closure(stack, false, false, set);
+
+        if ((int)dfa.size() >= kMaxDfaStates)
+        {
+            ResetDfa();
+            return Intern(set);
+        }
+        t = Intern(set);
+        dfa[d].next[cls] = t;
+        return t;
+    }
+
+    bool Compile(const std::wstring& pattern, bool glob, std::wstring& outErr)
+    {
+        *this = NamePattern();
+
+        std::wstring re;
+        if (glob)
+        {
+            re = L"^";
+            for (size_t i = 0; i < pattern.size(); ++i)
+            {
+                wchar_t c = pattern[i];
+                if (c == L'*') re += L".*";
+                else if (c == L'?') re += L'.';
+                else if (c == L'[' && pattern.find(L']', i + 2) != std::wstring::npos)
+                {
+                    size_t close = pattern.find(L']', i + 2);
+                    std::wstring body = pattern.substr(i + 1, close - i - 1);
+                    if (!body.empty() && body[0] == L'!') body[0] = L'^';
+                    re += L'[';
+                    for (wchar_t b : body)
+                    {
+                        if (b == L'\\') re += L'\\';
+                        re += b;
+                    }
+                    re += L']';
+                    i = close;
+                }
+                else
+                {
+                    if (wcschr(L"\\.+()|{}[]^$", c)) re += L'\\';
+                    re += c;
+                }
+            }
+            re += L'$';
+        }
+        else
+        {
+            re = pattern;
+        }
+
+        p = re.c_str();
+        pend = p + re.size();
+        int root = -1;
+        bool ok = ParseAlt(root);
+        if (ok && p < pend)
+        {
+            err = L"unmatched )";
+            ok = false;
+        }
+
+        Frag f;
+        if (ok) ok = Build(root, f);
+        p = pend = nullptr;
+        if (!ok)
+        {
+            outErr = err;
+            return false;
+        }
+
+        int m = NewState(NfaState::Match);
+        Patch(f.outs, m);
+        nfaStart = f.start;
+        mark.assign(nfa.size(), 0);
+
+        literal = RequiredLiteral(root);
+        BuildClasses();
+        ResetDfa();
+        valid = true;
+        return true;
+    }
+
+    bool Matches(const std::wstring& nameLower)
+    {
+        if (!valid) return false;
+        if (!literal.empty() && nameLower.find(literal) == std::wstring::npos) return false;
+
+        int d = 0;
+        for (wchar_t c : nameLower)
+        {
+            if (dfa[d].acceptNow) return true;
+            if (dfa[d].dead) return false;
+            d = Next(d, ClassOf(c));
+        }
+        return dfa[d].acceptNow || dfa[d].acceptEnd;
+    }
+};
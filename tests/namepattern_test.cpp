@@ -0,0 +1,130 @@
+// Tests for namepattern.h (glob / regex name matching). No Win32 needed:
+//   g++ -std=c++17 -I.. namepattern_test.cpp -o namepattern_test && ./namepattern_test
+//   cl /std:c++17 /EHsc /I.. namepattern_test.cpp
+// Exits non-zero and lists the failures if any case is wrong.
+
+#include "namepattern.h"
+
+#include <cstdio>
+
+static int g_failed = 0;
+
+// Names are matched lower-cased, as browse.cpp does
+static void Expect(const wchar_t* pattern, bool glob, const wchar_t* name, bool want)
+{
+    NamePattern np;
+    std::wstring err;
+    if (!np.Compile(pattern, glob, err))
+    {
+        std::wprintf(L"FAIL: %ls \"%ls\" did not compile: %ls\n", glob ? L"glob" : L"regex",
+                     pattern, err.c_str());
+        ++g_failed;
+        return;
+    }
+    std::wstring lower = name;
+    for (auto& c : lower) c = (wchar_t)std::towlower(c);
+    if (np.Matches(lower) != want)
+    {
+        std::wprintf(L"FAIL: %ls \"%ls\" on \"%ls\": expected %ls\n", glob ? L"glob" : L"regex",
+                     pattern, name, want ? L"match" : L"no match");
+        ++g_failed;
+    }
+}
+
+static void ExpectBad(const wchar_t* pattern)
+{
+    NamePattern np;
+    std::wstring err;
+    if (np.Compile(pattern, false, err) || err.empty())
+    {
+        std::wprintf(L"FAIL: regex \"%ls\" should not compile\n", pattern);
+        ++g_failed;
+    }
+}
+
+static void ExpectLiteral(const wchar_t* pattern, bool glob, const wchar_t* literal)
+{
+    NamePattern np;
+    std::wstring err;
+    if (!np.Compile(pattern, glob, err) || np.literal != literal)
+    {
+        std::wprintf(L"FAIL: \"%ls\" required literal \"%ls\", expected \"%ls\"\n", pattern,
+                     np.literal.c_str(), literal);
+        ++g_failed;
+    }
+}
+
+int main()
+{
+    // Glob: the whole name, * ? [..] [!..]
+    Expect(L"*.mkv", true, L"Movie.MKV", true);
+    Expect(L"*.mkv", true, L"movie.mkv.part", false);
+    Expect(L"ep??.mp4", true, L"ep01.mp4", true);
+    Expect(L"ep??.mp4", true, L"ep1.mp4", false);
+    Expect(L"s0[1-3]e*", true, L"s02e05.avi", true);
+    Expect(L"s0[1-3]e*", true, L"s04e05.avi", false);
+    Expect(L"s0[!1-3]e*", true, L"s04e05.avi", true);
+    Expect(L"a+b(1).mp4", true, L"a+b(1).mp4", true);   // regex chars are literal
+    Expect(L"a+b(1).mp4", true, L"aab1.mp4", false);
+
+    // Regex: found anywhere in the name unless anchored
+    Expect(L"holiday", false, L"Our Holiday 2019.mp4", true);
+    Expect(L"^holiday", false, L"Our Holiday 2019.mp4", false);
+    Expect(L"^our", false, L"Our Holiday 2019.mp4", true);
+    Expect(L"mp4$", false, L"clip.mp4", true);
+    Expect(L"mp4$", false, L"clip.mp4.bak", false);
+    Expect(L"^$", false, L"", true);
+
+    // Classes and escapes
+    Expect(L"\\d{4}", false, L"trip 2019.mkv", true);
+    Expect(L"\\d{4}", false, L"trip 201.mkv", false);
+    Expect(L"^[a-c]\\w+\\.avi$", false, L"Beach_day.avi", true);
+    Expect(L"^[a-c]\\w+\\.avi$", false, L"dune.avi", false);
+    Expect(L"^[^0-9]+$", false, L"nodigits", true);
+    Expect(L"^[^0-9]+$", false, L"digit5", false);
+    Expect(L"a\\sb", false, L"a b", true);
+    Expect(L"\\.", false, L"nodot", false);
+
+    // Alternation, groups and repeats
+    Expect(L"^(cat|dog)s?\\.mp4$", false, L"Dogs.mp4", true);
+    Expect(L"^(cat|dog)s?\\.mp4$", false, L"cow.mp4", false);
+    Expect(L"^(?:ab)+$", false, L"ababab", true);
+    Expect(L"^(?:ab)+$", false, L"ababa", false);
+    Expect(L"^x{2,3}$", false, L"xx", true);
+    Expect(L"^x{2,3}$", false, L"xxxx", false);
+    Expect(L"^x{2,}$", false, L"xxxxx", true);
+    Expect(L"^a.*z$", false, L"abcz", true);
+
+    // Case folding: literals are lower-cased when compiled
+    Expect(L"HOLIDAY", false, L"holiday.mp4", true);
+    Expect(L"*.MKV", true, L"x.mkv", true);
+    Expect(L"[A-C]x", false, L"bx", true);
+
+    // Required-literal prefilter
+    ExpectLiteral(L"holiday", false, L"holiday");
+    ExpectLiteral(L"^trip \\d+ (day|night)", false, L"trip ");
+    ExpectLiteral(L"*.mkv", true, L".mkv");
+    ExpectLiteral(L"cat|dog", false, L"");
+    Expect(L"^trip \\d+ (day|night)", false, L"Trip 12 Night.mp4", true);
+    Expect(L"^trip \\d+ (day|night)", false, L"Trip12 Night.mp4", false);
+
+    // Bad patterns are reported, not matched
+    ExpectBad(L"(abc");
+    ExpectBad(L"abc)");
+    ExpectBad(L"[abc");
+
+    // A long name goes through the DFA cache flush without changing answers
+    std::wstring longName(5000, L'a');
+    Expect(L"a*b", false, longName.c_str(), false);
+    Expect(L"a*b", false, (longName + L"b").c_str(), true);
+    Expect(L"^a*b$", false, (longName + L"b").c_str(), true);
+    Expect(L"^a*b$", false, (longName + L"ba").c_str(), false);
+
+    if (g_failed)
+    {
+        std::wprintf(L"%d case(s) failed\n", g_failed);
+        return 1;
+    }
+    std::wprintf(L"namepattern: all cases passed\n");
+    return 0;
+}
@@ -0,0 +1,89 @@
+// Known-answer tests for xxh64.h. No Win32 needed:
+//   g++ -std=c++17 -I.. xxh64_test.cpp -o xxh64_test && ./xxh64_test
+//   cl /std:c++17 /EHsc /I.. xxh64_test.cpp
+// The digests come from the reference XXH64 (seed 0). Exits non-zero and
+// lists the failures if any digest is wrong.
+
+#include "xxh64.h"
+
+#include <cstdio>
+#include <vector>
+
+static int g_failed = 0;
+
+// Hash in one call, and again fed in uneven pieces: both must give want
+static void Expect(const unsigned char* data, size_t len, uint64_t want)
+{
+    Xxh64 one;
+    one.Update(data, len);
+
+    Xxh64 pieces;
+    static const size_t kSteps[] = { 1, 3, 7, 16, 31, 32, 33, 5 };
+    size_t done = 0;
+    for (size_t k = 0; done < len; ++k)
+    {
+        size_t n = kSteps[k % (sizeof(kSteps) / sizeof(kSteps[0]))];
+        if (n > len - done) n = len - done;
+        pieces.Update(data + done, n);
+        done += n;
+    }
+
+    if (one.Digest() != want || pieces.Digest() != want)
+    {
+        std::printf("FAIL: %zu bytes: %016llx / %016llx, expected %016llx\n", len,
+                    (unsigned long long)one.Digest(), (unsigned long long)pieces.Digest(),
+                    (unsigned long long)want);
+        ++g_failed;
+    }
+}
+
+int main()
+{
+    // data[i] = i * 131 + 7: no runs, every byte value
+    std::vector<unsigned char> data(4096);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = (unsigned char)(i * 131 + 7);
+
+    static const struct { size_t len; uint64_t digest; } kCases[] =
+    {
+        {    0, 0xEF46DB3751D8E999ULL },
+        {    1, 0xA96C7F0CE858BBB7ULL },
+        {    3, 0xBED43740EE6332BBULL },
+        {    4, 0xFA212AE44B3BB23DULL },
+        {    7, 0x2744460DD675D2C0ULL },
+        {    8, 0x994B676B71CE94DDULL },
+        {    9, 0x572B84C18B983AF8ULL },
+        {   31, 0x6711D55E306B5D8FULL },
+        {   32, 0x07F7B8E3BC5D6E25ULL },
+        {   33, 0x09F85EEB4E1CBE9FULL },
+        {   63, 0xB7C9968C066CB6A5ULL },
+        {   64, 0x50D4159A0411632EULL },
+        {  100, 0x9DDADA11D3DC2D8FULL },
+        { 1000, 0x0BF0BDBCC82EB373ULL },
+        { 4096, 0xCF05ADF75ACA30CFULL },
+    };
+    for (const auto& c : kCases) Expect(data.data(), c.len, c.digest);
+
+    const char abc[] = "abc";
+    Expect((const unsigned char*)abc, 3, 0x44BC2CF5AD770999ULL);
+    const char fox[] = "The quick brown fox jumps over the lazy dog";
+    Expect((const unsigned char*)fox, sizeof(fox) - 1, 0x0B242D361FDA71BCULL);
+
+    // Reset starts a fresh hash
+    Xxh64 x;
+    x.Update(fox, sizeof(fox) - 1);
+    x.Reset();
+    x.Update(abc, 3);
+    if (x.Digest() != 0x44BC2CF5AD770999ULL)
+    {
+        std::printf("FAIL: Reset kept earlier input\n");
+        ++g_failed;
+    }
+
+    if (g_failed)
+    {
+        std::printf("%d case(s) failed\n", g_failed);
+        return 1;
+    }
+    std::printf("xxh64: all cases passed\n");
+    return 0;
+}
@@ -0,0 +1,124 @@
+// xxh64.h - streaming XXH64 for Browse's copy verification.
+//
+// Plain C++, no Win32: browse.cpp includes it, and tests/xxh64_test.cpp checks
+// it against reference digests.
+//
+// Fast enough to hash a copy on the thread that moves it without becoming the
+// bottleneck. Seed 0 only; the digest matches the reference XXH64.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+struct Xxh64
+{
+    static const uint64_t P1 = 11400714785074694791ULL;
+    static const uint64_t P2 = 14029467366897019727ULL;
+    static const uint64_t P3 = 1609587929392839161ULL;
+    static const uint64_t P4 = 9650029242287828579ULL;
+    static const uint64_t P5 = 2870177450012600261ULL;
+
+    uint64_t v[4];
+    uint64_t total = 0;
+    unsigned char mem[32];
+    size_t memSize = 0;
+
+    Xxh64() { Reset(); }
+
+    void Reset()
+    {
+        v[0] = P1 + P2;
+        v[1] = P2;
+        v[2] = 0;
+        v[3] = 0 - P1;
+        total = 0;
+        memSize = 0;
+    }
+
+    static uint64_t Rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+    static uint64_t Read64(const unsigned char* p)
+    {
+        uint64_t x;
+        memcpy(&x, p, 8);
+        return x;
+    }
+    static uint64_t Round(uint64_t acc, uint64_t in)
+    {
+        acc += in * P2;
+        return Rotl(acc, 31) * P1;
+    }
+    static uint64_t Merge(uint64_t h, uint64_t val)
+    {
+        h ^= Round(0, val);
+        return h * P1 + P4;
+    }
+
+    void Update(const void* data, size_t len)
+    {
+        const unsigned char* p = (const unsigned char*)data;
+        total += len;
+        if (memSize + len < 32)
+        {
+            memcpy(mem + memSize, p, len);
+            memSize += len;
+            return;
+        }
+        if (memSize)
+        {
+            size_t fill = 32 - memSize;
+            memcpy(mem + memSize, p, fill);
+            for (int i = 0; i < 4; ++i) v[i] = Round(v[i], Read64(mem + 8 * i));
+            p += fill;
+            len -= fill;
+            memSize = 0;
+        }
+        for (; len >= 32; p += 32, len -= 32)
+        {
+            v[0] = Round(v[0], Read64(p));
+            v[1] = Round(v[1], Read64(p + 8));
+            v[2] = Round(v[2], Read64(p + 16));
+            v[3] = Round(v[3], Read64(p + 24));
+        }
+        memcpy(mem, p, len);
+        memSize = len;
+    }
+
+    uint64_t Digest() const
+    {
+        uint64_t h;
+        if (total >= 32)
+        {
+            h = Rotl(v[0], 1) + Rotl(v[1], 7) + Rotl(v[2], 12) + Rotl(v[3], 18);
+            for (int i = 0; i < 4; ++i) h = Merge(h, v[i]);
+        }
+        else
+        {
+            h = P5;
+        }
+        h += total;
+
+        const unsigned char* p = mem;
+        size_t left = memSize;
+        for (; left >= 8; p += 8, left -= 8)
+            h = Rotl(h ^ Round(0, Read64(p)), 27) * P1 + P4;
+        if (left >= 4)
+        {
+            uint32_t k;
+            memcpy(&k, p, 4);
+            h = Rotl(h ^ ((uint64_t)k * P1), 23) * P2 + P3;
+            p += 4;
+            left -= 4;
+        }
+        for (; left; ++p, --left)
+            h = Rotl(h ^ (*p * P5), 11) * P1;
+
+        h ^= h >> 33;
+        h *= P2;
+        h ^= h >> 29;
+        h *= P3;
+        h ^= h >> 32;
+        return h;
+    }
+};